@@ -0,0 +1,133 @@
+//
+// Created by Ben Meyers on 3/6/26.
+//
+
+#include "Activation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+// ---- forward kernels: a = f(z) ----
+// written as straight loops with no data-dependent branches so the compiler can vectorize them
+
+static void identityForward(const float* z, float* a, size_t n) {
+    std::copy(z, z + n, a);
+}
+
+static void sigmoidForward(const float* z, float* a, size_t n) {
+    for (size_t i = 0; i < n; i++) a[i] = 1.0f / (1.0f + std::exp(-z[i]));
+}
+
+static void reluForward(const float* z, float* a, size_t n) {
+    for (size_t i = 0; i < n; i++) a[i] = std::max(z[i], 0.0f);
+}
+
+static void leakyReluForward(const float* z, float* a, size_t n) {
+    // max(z, 0.01z) is z for z > 0 and 0.01z otherwise
+    for (size_t i = 0; i < n; i++) a[i] = std::max(z[i], 0.01f * z[i]);
+}
+
+static void tanhForward(const float* z, float* a, size_t n) {
+    for (size_t i = 0; i < n; i++) a[i] = std::tanh(z[i]);
+}
+
+// tanh approximation of GELU: 0.5z(1 + tanh(sqrt(2/pi)(z + 0.044715z^3)))
+static constexpr float GELU_K = 0.7978845608f;  // sqrt(2/pi)
+static constexpr float GELU_C = 0.044715f;
+static void geluForward(const float* z, float* a, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        const float x = z[i];
+        a[i] = 0.5f * x * (1.0f + std::tanh(GELU_K * (x + GELU_C * x * x * x)));
+    }
+}
+
+static void softmaxForward(const float* z, float* a, size_t n) {
+    if (n == 0) return;
+    // get maximum value
+    const float maxVal = *std::max_element(z, z + n);
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; i++) {
+        // summation of e^[value - maxVal]
+        a[i] = std::exp(z[i] - maxVal);
+        sum += a[i];
+    }
+    // divide each term by this sum
+    const float inv = 1.0f / sum;
+    for (size_t i = 0; i < n; i++) a[i] *= inv;
+}
+
+// ---- backward kernels: delta = err ⊙ f'(z) ----
+
+static void identityBackward(const float*, const float*, const float* err, float* delta, size_t n) {
+    std::copy(err, err + n, delta);
+}
+
+// sigmoid'(a) = a*(1-a)  — takes post-activation value
+static void sigmoidBackward(const float*, const float* a, const float* err, float* delta, size_t n) {
+    for (size_t i = 0; i < n; i++) delta[i] = err[i] * a[i] * (1.0f - a[i]);
+}
+
+// relu'(z) = z > 0 ? 1 : 0  — takes pre-activation value
+static void reluBackward(const float* z, const float*, const float* err, float* delta, size_t n) {
+    for (size_t i = 0; i < n; i++) delta[i] = err[i] * static_cast<float>(z[i] > 0.0f);
+}
+
+static void leakyReluBackward(const float* z, const float*, const float* err, float* delta, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        const float on = static_cast<float>(z[i] > 0.0f);
+        delta[i] = err[i] * (0.01f + 0.99f * on);
+    }
+}
+
+// tanh'(a) = 1 - a^2
+static void tanhBackward(const float*, const float* a, const float* err, float* delta, size_t n) {
+    for (size_t i = 0; i < n; i++) delta[i] = err[i] * (1.0f - a[i] * a[i]);
+}
+
+static void geluBackward(const float* z, const float*, const float* err, float* delta, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        const float x = z[i];
+        const float t = std::tanh(GELU_K * (x + GELU_C * x * x * x));
+        const float dInner = GELU_K * (1.0f + 3.0f * GELU_C * x * x);
+        delta[i] = err[i] * (0.5f * (1.0f + t) + 0.5f * x * (1.0f - t * t) * dInner);
+    }
+}
+
+// softmax jacobian applied to error vector: a ⊙ (e - <a,e>)
+static void softmaxBackward(const float*, const float* a, const float* err, float* delta, size_t n) {
+    float dot = 0.0f;
+    for (size_t i = 0; i < n; i++) dot += a[i] * err[i];
+    for (size_t i = 0; i < n; i++) delta[i] = a[i] * (err[i] - dot);
+}
+
+// ---- the registry, indexed by Activation ----
+static constexpr ActivationInfo REGISTRY[] = {
+    // id                     token        name         label    color            norm   sparse  output loss                      kernels
+    {Activation::Input,     "input",     "Input",     "",      200, 200, 200,   true,  false,  OutputLoss::SquaredError,        identityForward,  identityBackward},   // white-gray
+    {Activation::Sigmoid,   "sigmoid",   "Sigmoid",   "sig",    80, 140, 255,   false, false,  OutputLoss::BinaryCrossEntropy,  sigmoidForward,   sigmoidBackward},    // blue
+    {Activation::ReLU,      "ReLU",      "ReLU",      "ReLU",   80, 220, 100,   true,  true,   OutputLoss::SquaredError,        reluForward,      reluBackward},       // green
+    {Activation::Softmax,   "softmax",   "Softmax",   "SM",    255, 160,  50,   false, false,  OutputLoss::CrossEntropy,        softmaxForward,   softmaxBackward},    // orange
+    {Activation::Tanh,      "tanh",      "Tanh",      "tanh",  180, 100, 255,   false, false,  OutputLoss::SquaredError,        tanhForward,      tanhBackward},       // purple
+    {Activation::LeakyReLU, "LeakyReLU", "LeakyReLU", "LReLU",  60, 200, 170,   true,  false,  OutputLoss::SquaredError,        leakyReluForward, leakyReluBackward},  // teal
+    {Activation::GELU,      "GELU",      "GELU",      "GELU",  230, 220,  80,   true,  false,  OutputLoss::SquaredError,        geluForward,      geluBackward},       // yellow
+    {Activation::Identity,  "identity",  "Identity",  "id",    160, 160, 160,   true,  false,  OutputLoss::SquaredError,        identityForward,  identityBackward},   // gray
+};
+
+// table order has to match the enum so lookups are a plain index
+static constexpr bool RegistryInOrder() {
+    for (size_t i = 0; i < std::size(REGISTRY); i++)
+        if (static_cast<size_t>(REGISTRY[i].id) != i) return false;
+    return true;
+}
+static_assert(RegistryInOrder(), "Activation registry rows must follow the Activation enum order");
+
+const ActivationInfo& GetActivation(const Activation a) {
+    return REGISTRY[static_cast<size_t>(a)];
+}
+
+const ActivationInfo* FindActivation(const std::string_view token) {
+    for (const auto& info : REGISTRY)
+        if (info.token == token) return &info;
+    return nullptr;
+}
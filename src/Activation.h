@@ -0,0 +1,51 @@
+//
+// Created by Ben Meyers on 3/6/26.
+//
+
+#ifndef NEURAL_NETWORK_CIRCUIT_VISUALIZATION_ACTIVATION_H
+#define NEURAL_NETWORK_CIRCUIT_VISUALIZATION_ACTIVATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// available activation functions
+// to add one: append it here and give it a row in the registry table in Activation.cpp
+enum class Activation {Input, Sigmoid, ReLU, Softmax, Tanh, LeakyReLU, GELU, Identity};
+
+// loss an output layer trains on. the two cross-entropies are paired with the activation whose derivative
+// they cancel (softmax, sigmoid), so their delta is just a - y; squared error goes back through f'(z)
+enum class OutputLoss {SquaredError, CrossEntropy, BinaryCrossEntropy};
+
+// everything the network and the renderer need to know about one activation.
+// kernels run over a whole contiguous span, so dispatch happens once per layer, not per neuron
+struct ActivationInfo {
+    Activation       id;
+    std::string_view token;  // how it's written in nn.cfg
+    std::string_view name;   // for logs / printing
+    std::string_view label;  // drawn on each neuron
+    uint8_t r, g, b;         // neuron color
+
+    // unbounded outputs: the renderer normalizes neuron alpha by the layer's max |a|
+    bool normalizeByMax;
+    // derivative is exactly zero wherever the unit is off, so the backward pass may skip those rows
+    bool sparseGradient;
+    // what it trains on as the output layer (see OutputLoss)
+    OutputLoss outputLoss;
+
+    // a = f(z) over n values
+    void (*forward)(const float* z, float* a, size_t n);
+    // delta = dLoss/dz given err = dLoss/da. gets z and a so each one can use whichever is cheaper
+    void (*backward)(const float* z, const float* a, const float* err, float* delta, size_t n);
+};
+
+// registry lookups
+[[nodiscard]] const ActivationInfo& GetActivation(Activation a);
+// nullptr if no activation uses that config token
+[[nodiscard]] const ActivationInfo* FindActivation(std::string_view token);
+
+inline std::string_view ActivationName(const Activation& a) {
+    return GetActivation(a).name;
+}
+
+#endif //NEURAL_NETWORK_CIRCUIT_VISUALIZATION_ACTIVATION_H
@@ -10,7 +10,7 @@
 Actor::~Actor() {
     for (auto& comp : mComponents)
     {
-        delete comp;
+        gGame.DestroyComponent(comp);
     }
     mComponents.clear();
 }
@@ -18,10 +18,7 @@ Actor::~Actor() {
 
 void Actor::Update(float deltaTime)
 {
-    for (auto& comp : mComponents)
-    {
-        comp->Update(deltaTime);
-    }
+    // components are updated by their own pools' systems, before any actor
     HandleUpdate(deltaTime);
 }
 
@@ -36,10 +33,7 @@ void Actor::HandleRender() {
 void Actor::Input(const bool keys[], SDL_MouseButtonFlags mouseButtons,
                   const Vector2& posMouse)
 {
-    for (auto& c : mComponents)
-    {
-        c->Input(keys, mouseButtons, posMouse);
-    }
+    // components get input from their own pools' systems, before any actor
     HandleInput(keys, mouseButtons, posMouse);
 }
 
@@ -6,9 +6,15 @@
 #define RELATIVITY_ACTOR_H
 #include <vector>
 
+#include "Component.h"
+#include "Pool.h"
 #include "Transform.h"
 #include "SDL3/SDL_mouse.h"
-class Component;
+class Actor;
+// T's pool lives in Game, which can't be included here; defined at the end of Game.h
+template <typename T>
+T* NewComponent(Actor* owner);
+
 class Actor {
 public:
     virtual ~Actor();
@@ -19,26 +25,26 @@ public:
     template <typename T>
     T* CreateComponent()
     {
-        // 'this' is the owner (an Actor) for the Component (required in Component constructor)
-        T* component = new T(this);
+        // constructed in T's pool; 'this' is the owner (an Actor) for the Component (required in Component constructor)
+        T* component = NewComponent<T>(this);
+        static_cast<Component*>(component)->mType = PoolTypeId<T>();
 
         mComponents.emplace_back(component);
 
         return component;
     }
 
-    // Returns component of type T, or nullptr if it doesn't exist
+    // Returns component of exactly type T, or nullptr if it doesn't exist
     template <typename T>
     T* GetComponent() const
     {
-        // Loop over all components
+        // each component knows its pool's type id, so this is an integer compare per component
+        const uint32_t type = PoolTypeId<T>();
         for (auto c : mComponents)
         {
-            // dynamic_cast will return nullptr if c is not type T*
-            T* t = dynamic_cast<T*>(c);
-            if (t)
+            if (c->mType == type)
             {
-                return t;
+                return static_cast<T*>(c);
             }
         }
 
@@ -50,6 +56,11 @@ public:
     void Input(const bool keys[], SDL_MouseButtonFlags mouseButtons, const Vector2& posMouse);
     void Destroy();
 
+    // visual state changed since the last drawn frame. when no actor is dirty, Game skips the frame
+    [[nodiscard]] bool IsDirty() const { return mDirty; }
+    void MarkDirty() { mDirty = true; }
+    void ClearDirty() { mDirty = false; }
+
     explicit Actor() = default;
 protected:
     virtual void HandleRender();
@@ -60,6 +71,7 @@ protected:
 private:
     Transform mTransform;
     std::vector<Component*> mComponents;
+    bool mDirty = true;  // never drawn yet
 };
 
 
@@ -0,0 +1,94 @@
+//
+// Created by Ben Meyers on 3/14/26.
+//
+
+#include "CircleAtlas.h"
+#include <algorithm>
+#include <cstdint>
+#include "Math.h"
+
+CircleAtlas::~CircleAtlas() {
+    Destroy();
+}
+
+void CircleAtlas::Destroy() {
+    if (mTexture) SDL_DestroyTexture(mTexture);
+    mTexture = nullptr;
+    mSprites.clear();
+}
+
+bool CircleAtlas::Build(SDL_Renderer* renderer, float maxRadius) {
+    Destroy();
+    maxRadius = Math::Max(maxRadius, MIN_RADIUS);
+
+    // === LAYOUT: shelf-pack the sprites left to right, wrapping into new rows ===
+    constexpr int ATLAS_WIDTH = 1024;
+    struct Placed { float radius; int x, y, side; };
+    std::vector<Placed> placed;
+    int x = 0, y = 0, shelfHeight = 0;
+    for (float r = MIN_RADIUS; ; r *= RADIUS_STEP) {
+        r = Math::Min(r, maxRadius);
+        // 1px of padding on each side for the anti-aliased rim
+        const int side = static_cast<int>(std::ceil(2.0f * r)) + 2;
+        if (side > ATLAS_WIDTH) break;
+        if (x + side > ATLAS_WIDTH) {
+            x = 0;
+            y += shelfHeight;
+            shelfHeight = 0;
+        }
+        placed.push_back({r, x, y, side});
+        x += side;
+        shelfHeight = Math::Max(shelfHeight, side);
+        if (r >= maxRadius) break;
+    }
+    const int atlasHeight = y + shelfHeight;
+    if (placed.empty() || atlasHeight <= 0) return false;
+
+    // === RASTERIZE: white pixels, alpha = how much of the pixel the circle covers ===
+    std::vector<uint32_t> pixels(static_cast<size_t>(ATLAS_WIDTH) * atlasHeight, 0u);
+    for (const auto& p : placed) {
+        const float center = static_cast<float>(p.side) * 0.5f;
+        for (int py = 0; py < p.side; ++py) {
+            for (int px = 0; px < p.side; ++px) {
+                const float dx = static_cast<float>(px) + 0.5f - center;
+                const float dy = static_cast<float>(py) + 0.5f - center;
+                // distance to the edge, in pixels, gives a one-pixel linear ramp across the rim
+                const float coverage = Math::Clamp(p.radius + 0.5f - Math::Sqrt(dx*dx + dy*dy), 0.0f, 1.0f);
+                const auto alpha = static_cast<uint32_t>(coverage * 255.0f + 0.5f);
+                // RGBA32 is byte order r,g,b,a in memory
+                uint8_t* texel = reinterpret_cast<uint8_t*>(&pixels[static_cast<size_t>(p.y + py) * ATLAS_WIDTH + p.x + px]);
+                texel[0] = 255; texel[1] = 255; texel[2] = 255; texel[3] = static_cast<uint8_t>(alpha);
+            }
+        }
+    }
+
+    mTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, ATLAS_WIDTH, atlasHeight);
+    if (!mTexture) return false;
+    SDL_UpdateTexture(mTexture, nullptr, pixels.data(), ATLAS_WIDTH * static_cast<int>(sizeof(uint32_t)));
+    SDL_SetTextureBlendMode(mTexture, SDL_BLENDMODE_BLEND);
+    SDL_SetTextureScaleMode(mTexture, SDL_SCALEMODE_LINEAR);
+
+    const float invW = 1.0f / static_cast<float>(ATLAS_WIDTH);
+    const float invH = 1.0f / static_cast<float>(atlasHeight);
+    for (const auto& p : placed) {
+        const auto side = static_cast<float>(p.side);
+        mSprites.push_back({p.radius, side * 0.5f,
+                            {static_cast<float>(p.x) * invW, static_cast<float>(p.y) * invH, side * invW, side * invH}});
+    }
+    return true;
+}
+
+bool CircleAtlas::Quad(float cx, float cy, float radius, SDL_FRect& dst, SDL_FRect& uv) const {
+    if (!mTexture || radius <= 0.0f) return false;
+
+    // smallest sprite that's at least this big (or the biggest we have)
+    auto it = std::lower_bound(mSprites.begin(), mSprites.end(), radius,
+                               [](const Sprite& s, float r) { return s.radius < r; });
+    if (it == mSprites.end()) --it;
+
+    // scale the whole sprite so its circle edge sits at the requested radius
+    const float half = it->half * (radius / it->radius);
+    dst = {cx - half, cy - half, 2.0f * half, 2.0f * half};
+    uv  = it->uv;
+    return true;
+}
@@ -0,0 +1,46 @@
+//
+// Created by Ben Meyers on 3/14/26.
+//
+
+#ifndef NEURAL_NETWORK_CIRCUIT_VISUALIZATION_CIRCLEATLAS_H
+#define NEURAL_NETWORK_CIRCUIT_VISUALIZATION_CIRCLEATLAS_H
+
+#include <vector>
+#include "SDL3/SDL_render.h"
+
+// One texture holding anti-aliased white circle sprites at quantized radii.
+// A circle is then a single textured quad whose vertex color tints it (RGBA modulation),
+// so any number of them batch into one SDL_RenderGeometry call.
+class CircleAtlas {
+public:
+    // each sprite radius is this factor bigger than the last
+    static constexpr float RADIUS_STEP = 1.08f;
+    static constexpr float MIN_RADIUS  = 1.0f;
+
+    CircleAtlas() = default;
+    ~CircleAtlas();
+    CircleAtlas(const CircleAtlas&) = delete;
+    CircleAtlas& operator=(const CircleAtlas&) = delete;
+
+    // (re)rasterize every sprite up to maxRadius. called at startup and whenever the output size changes
+    bool Build(SDL_Renderer* renderer, float maxRadius);
+    void Destroy();
+
+    [[nodiscard]] SDL_Texture* GetTexture() const { return mTexture; }
+    [[nodiscard]] float MaxRadius() const { return mSprites.empty() ? 0.0f : mSprites.back().radius; }
+
+    // picks the smallest sprite at least as big as radius, and the quad (dst) + texture coords (uv)
+    // that land that sprite's edge exactly on the requested circle. false if the atlas isn't built
+    bool Quad(float cx, float cy, float radius, SDL_FRect& dst, SDL_FRect& uv) const;
+
+private:
+    struct Sprite {
+        float     radius;  // rasterized circle radius in px
+        float     half;    // half the sprite's side length in px (radius + AA padding)
+        SDL_FRect uv;      // normalized texture rect
+    };
+    std::vector<Sprite> mSprites;  // ascending radius
+    SDL_Texture* mTexture = nullptr;
+};
+
+#endif //NEURAL_NETWORK_CIRCUIT_VISUALIZATION_CIRCLEATLAS_H
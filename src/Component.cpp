@@ -42,7 +42,6 @@ void Component::Input(const bool keys[], SDL_MouseButtonFlags mouseButtons,
 }
 void Component::SetDrawOrder(int order)
 {
-    gGame.RemoveRenderable(this);
     mDrawOrder = order;
-    gGame.AddRenderable(this);
+    gGame.MarkDrawOrderDirty();
 }
\ No newline at end of file
@@ -7,6 +7,7 @@
 
 
 #pragma once
+#include <cstdint>
 #include "SDL3/SDL_mouse.h"
 #include "Math.h"
 class Actor;
@@ -37,6 +38,7 @@ protected:
 private:
     Actor* mOwner;
     int mDrawOrder = 100;
+    uint32_t mType = UINT32_MAX;  // PoolTypeId of the concrete type, set by Actor::CreateComponent
 };
 
 #endif //RELATIVITY_COMPONENT_H
\ No newline at end of file
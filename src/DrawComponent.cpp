@@ -4,14 +4,16 @@
 
 #include "DrawComponent.h"
 #include "Game.h"
+#include "Perf.h"
+#include "Trace.h"
 
 DrawComponent::DrawComponent(class Actor *owner) : Component(owner) {
     mRenderer = gGame.GetRenderer();
-    gGame.AddRenderable(this);
+    gGame.MarkDrawOrderDirty();
 }
 
 DrawComponent::~DrawComponent() {
-    gGame.RemoveRenderable(this);
+    gGame.MarkDrawOrderDirty();
 }
 
 void DrawComponent::HandleUpdate(float deltaTime) {
@@ -19,34 +21,130 @@ void DrawComponent::HandleUpdate(float deltaTime) {
 }
 
 void DrawComponent::HandleRender() {
+    NN_TRACE_SCOPE("DrawComponent::Submit");
     Component::HandleRender();
+    if (mClipped) SDL_SetRenderClipRect(mRenderer, &mClip);
     SDL_SetRenderDrawBlendMode(mRenderer, SDL_BLENDMODE_BLEND);
-    for (const auto& shape : mShapes) {
-        shape->Draw(mRenderer);
+    // everything but text shares the blend state: one call for flat shapes, one for the circle sprites
+    DrawTextures();
+    for (const GeometryBatch* batch : mBatches) batch->Submit(mRenderer);
+    {
+        NN_TRACE_SCOPE("DrawComponent::BuildGeometry");
+        BuildGeometry();
     }
+    mGeometry.Submit(mRenderer);
+    mSprites.Submit(mRenderer, gGame.GetCircleAtlas().GetTexture());
+    DrawTexts();
     SDL_SetRenderDrawBlendMode(mRenderer, SDL_BLENDMODE_NONE);
-    mShapes.clear();
+    if (mClipped) SDL_SetRenderClipRect(mRenderer, nullptr);
+
+    // drop this frame's commands but keep the memory for the next one
+    mTextures.Clear();
+    mBatches.clear();
+    mLines.Clear();
+    mRects.Clear();
+    mOutlineRects.Clear();
+    mCircles.Clear();
+    mTexts.Clear();
+    mGeometry.Clear();
+    mSprites.Clear();
 }
 
 void DrawComponent::AddText(float x, float y, std::string_view txt, float scale) {
-    mShapes.push_back(std::make_unique<Text>(x, y, scale, std::string(txt), Game::MAX_COLOR, Game::MAX_COLOR, Game::MAX_COLOR, Game::MAX_COLOR));
+    mTexts.x.push_back(x);
+    mTexts.y.push_back(y);
+    mTexts.scale.push_back(scale);
+    mTexts.color.push_back({Game::MAX_COLOR, Game::MAX_COLOR, Game::MAX_COLOR, Game::MAX_COLOR});
+    mTexts.label.push_back(GlyphAtlas::NO_LABEL);
+    mTexts.offset.push_back(mTexts.chars.size());
+    mTexts.chars.append(txt);
+    mTexts.chars.push_back('\0');
+}
+
+void DrawComponent::AddText(float x, float y, GlyphAtlas::Label label, float scale) {
+    mTexts.x.push_back(x);
+    mTexts.y.push_back(y);
+    mTexts.scale.push_back(scale);
+    mTexts.color.push_back({Game::MAX_COLOR, Game::MAX_COLOR, Game::MAX_COLOR, Game::MAX_COLOR});
+    mTexts.label.push_back(label);
+    mTexts.offset.push_back(0);
+}
+
+
+void DrawComponent::Commands::AddFilledCircle(float cx, float cy, float radius, Uint8 r, Uint8 g, Uint8 b, Uint8 a) {
+    circles.cx.push_back(cx);
+    circles.cy.push_back(cy);
+    circles.radius.push_back(radius);
+    circles.color.push_back({r, g, b, a});
+}
+
+void DrawComponent::Commands::AddText(float x, float y, GlyphAtlas::Label label, float scale) {
+    texts.x.push_back(x);
+    texts.y.push_back(y);
+    texts.scale.push_back(scale);
+    texts.color.push_back({Game::MAX_COLOR, Game::MAX_COLOR, Game::MAX_COLOR, Game::MAX_COLOR});
+    texts.label.push_back(label);
+    texts.offset.push_back(0);
 }
 
+void DrawComponent::Commands::Clear() {
+    circles.Clear();
+    texts.Clear();
+}
+
+void DrawComponent::Append(const Commands& commands) {
+    const CircleBuffer& c = commands.circles;
+    mCircles.cx.insert(mCircles.cx.end(), c.cx.begin(), c.cx.end());
+    mCircles.cy.insert(mCircles.cy.end(), c.cy.begin(), c.cy.end());
+    mCircles.radius.insert(mCircles.radius.end(), c.radius.begin(), c.radius.end());
+    mCircles.color.insert(mCircles.color.end(), c.color.begin(), c.color.end());
+
+    const TextBuffer& t = commands.texts;
+    mTexts.x.insert(mTexts.x.end(), t.x.begin(), t.x.end());
+    mTexts.y.insert(mTexts.y.end(), t.y.begin(), t.y.end());
+    mTexts.scale.insert(mTexts.scale.end(), t.scale.begin(), t.scale.end());
+    mTexts.color.insert(mTexts.color.end(), t.color.begin(), t.color.end());
+    mTexts.label.insert(mTexts.label.end(), t.label.begin(), t.label.end());
+    // slices only carry interned labels, whose offsets are never read
+    mTexts.offset.insert(mTexts.offset.end(), t.offset.begin(), t.offset.end());
+}
 
 void DrawComponent::AddFilledCircle(float cx, float cy, float radius, Uint8 r, Uint8 g,Uint8 b,Uint8 a) {
-    mShapes.push_back(std::make_unique<Circle>(cx, cy, radius, r, g, b, a));
+    mCircles.cx.push_back(cx);
+    mCircles.cy.push_back(cy);
+    mCircles.radius.push_back(radius);
+    mCircles.color.push_back({r, g, b, a});
 }
 
 void DrawComponent::AddLine(float x1, float y1, float x2, float y2, Uint8 r, Uint8 g,Uint8 b,Uint8 a, int thickness) {
-    mShapes.push_back(std::make_unique<LineSegment>(x1, y1, x2, y2, r, g, b, a, thickness));
+    mLines.x1.push_back(x1);
+    mLines.y1.push_back(y1);
+    mLines.x2.push_back(x2);
+    mLines.y2.push_back(y2);
+    mLines.thickness.push_back(thickness);
+    mLines.color.push_back({r, g, b, a});
 }
 
 void DrawComponent::AddRect(float x, float y, float w, float h, Uint8 r, Uint8 g, Uint8 b, Uint8 a) {
-    mShapes.push_back(std::make_unique<Rect>(x, y, w, h, r, g, b, a));
+    mRects.rect.push_back({x, y, w, h});
+    mRects.color.push_back({r, g, b, a});
 }
 
 void DrawComponent::AddOutlineRect(float x, float y, float w, float h, Uint8 r, Uint8 g, Uint8 b, Uint8 a) {
-    mShapes.push_back(std::make_unique<OutlineRect>(x, y, w, h, r, g, b, a));
+    mOutlineRects.rect.push_back({x, y, w, h});
+    mOutlineRects.color.push_back({r, g, b, a});
+}
+
+void DrawComponent::AddBatch(const GeometryBatch* batch) {
+    if (batch && !batch->Empty()) mBatches.push_back(batch);
+}
+
+void DrawComponent::AddTexture(SDL_Texture* texture, const SDL_FRect& dst, Uint8 r, Uint8 g, Uint8 b, Uint8 a, SDL_BlendMode blend) {
+    if (!texture) return;
+    mTextures.texture.push_back(texture);
+    mTextures.dst.push_back(dst);
+    mTextures.color.push_back({r, g, b, a});
+    mTextures.blend.push_back(blend);
 }
 
 void DrawComponent::AddScaledWidthRect(float x, float y, float maxW, float h, float pct, Uint8 r, Uint8 g,
@@ -86,67 +184,115 @@ void DrawComponent::SetColor(Uint8 r, Uint8 g, Uint8 b, Uint8 a) const {
     SDL_SetRenderDrawColor(mRenderer, r, g, b, a);
 }
 
-void DrawComponent::Rect::Draw(SDL_Renderer* renderer) {
-    SDL_SetRenderDrawColor(renderer, _r, _g, _b, _a);
-    SDL_FRect rct{_x, _y, _w, _h};
-    SDL_RenderFillRect(renderer, &rct);
+void DrawComponent::SetClipRect(const SDL_Rect* rect) {
+    mClipped = rect != nullptr;
+    if (rect) mClip = *rect;
 }
 
-void DrawComponent::Text::Draw(SDL_Renderer* renderer) {
-    SDL_SetRenderDrawColor(renderer, _r, _g, _b, _a);
-    if (_scale != 1.0f) {
-        SDL_SetRenderScale(renderer, _scale, _scale);
-    }
-    SDL_RenderDebugTextFormat(renderer, _x / _scale, _y / _scale, "%s", _text.c_str());
-    if (_scale != 1.0f) {
-        SDL_SetRenderScale(renderer, 1.0f, 1.0f);
-    }
+void DrawComponent::LineBuffer::Clear() {
+    x1.clear(); y1.clear(); x2.clear(); y2.clear();
+    thickness.clear();
+    color.clear();
+}
+
+void DrawComponent::CircleBuffer::Clear() {
+    cx.clear(); cy.clear(); radius.clear();
+    color.clear();
 }
 
-void DrawComponent::OutlineRect::Draw(SDL_Renderer* renderer) {
-    SDL_SetRenderDrawColor(renderer, _r, _g, _b, _a);
-    SDL_FRect rct{_x, _y, _w, _h};
-    SDL_RenderRect(renderer, &rct);
+void DrawComponent::RectBuffer::Clear() {
+    rect.clear();
+    color.clear();
 }
 
+void DrawComponent::TextureBuffer::Clear() {
+    texture.clear();
+    dst.clear();
+    color.clear();
+    blend.clear();
+}
 
-void DrawComponent::LineSegment::Draw(SDL_Renderer* renderer) {
-    // ditch empty lines
-    float dx = _x2 - _x;
-    float dy = _y2 - _y;
-    float len = std::sqrt(dx*dx + dy*dy);
-    if (len < 1.0f) return;
+void DrawComponent::TextBuffer::Clear() {
+    x.clear(); y.clear(); scale.clear();
+    color.clear();
+    label.clear();
+    offset.clear();
+    chars.clear();
+}
 
-    SDL_SetRenderDrawColor(renderer, _r, _g, _b, _a);
-    if (_thickness <= 1) { 
-        SDL_RenderLine(renderer, _x, _y, _x2, _y2); 
-        return; 
-    }
-    
-    // if the line's direction vector is [dx, dy], then the perpendicular is [-dy, dx]
-    // then divide by len to normalize (number of pixels to shift)
-    float px = -dy / len;
-    float py = dx / len;   
-
-    // if thickness is two, we want each line shifted a half a pixel
-    // half = (2 - 1) * 0.5f
-    // if thickness was 4, we'd have (4-1) * 0.5f = 1.5f
-    //....this would have us looping from offsets of -1.5 to 1.5, exactly what we want
-    float half = (_thickness - 1) * 0.5f;
-    for (int i = 0; i < _thickness; ++i) {
-        float offset = i - half;
-        SDL_RenderLine(renderer, _x + px * offset, _y + py * offset, _x2 + px * offset, _y2 + py * offset);
+void DrawComponent::DrawTextures() const {
+    for (size_t i = 0; i < mTextures.texture.size(); ++i) {
+        SDL_Texture* tex = mTextures.texture[i];
+        const SDL_Color& c = mTextures.color[i];
+        // modulation lives on the texture, so set it every time (the same texture may be queued twice)
+        SDL_SetTextureColorMod(tex, c.r, c.g, c.b);
+        SDL_SetTextureAlphaMod(tex, c.a);
+        SDL_SetTextureBlendMode(tex, mTextures.blend[i]);
+        SDL_RenderTexture(mRenderer, tex, nullptr, &mTextures.dst[i]);
+        Perf::CountDraw(4);
     }
 }
 
+std::string_view DrawComponent::TextAt(size_t i) const {
+    const GlyphAtlas::Label label = mTexts.label[i];
+    if (label != GlyphAtlas::NO_LABEL) return gGame.GetGlyphAtlas().Text(label);
+    return mTexts.chars.c_str() + mTexts.offset[i];
+}
 
+void DrawComponent::DrawTexts() {
+    const GlyphAtlas& atlas = gGame.GetGlyphAtlas();
+    if (atlas.GetTexture()) {
+        for (size_t i = 0; i < mTexts.offset.size(); ++i) {
+            const SDL_Color& c = mTexts.color[i];
+            atlas.Layout(mTextBatch, mTexts.x[i], mTexts.y[i], TextAt(i), mTexts.scale[i],
+                         GeometryBatch::ToFColor(c.r, c.g, c.b, c.a));
+        }
+        mTextBatch.Submit(mRenderer, atlas.GetTexture());
+        mTextBatch.Clear();
+        return;
+    }
+
+    // no atlas (texture creation failed): one debug-text call per label
+    std::string text;
+    for (size_t i = 0; i < mTexts.offset.size(); ++i) {
+        const SDL_Color& c = mTexts.color[i];
+        const float scale = mTexts.scale[i];
+        SDL_SetRenderDrawColor(mRenderer, c.r, c.g, c.b, c.a);
+        if (scale != 1.0f) {
+            SDL_SetRenderScale(mRenderer, scale, scale);
+        }
+        text.assign(TextAt(i));
+        SDL_RenderDebugText(mRenderer, mTexts.x[i] / scale, mTexts.y[i] / scale, text.c_str());
+        Perf::CountDraw(4 * text.size());
+        if (scale != 1.0f) {
+            SDL_SetRenderScale(mRenderer, 1.0f, 1.0f);
+        }
+    }
+}
 
-void DrawComponent::Circle::Draw(SDL_Renderer* renderer) {
-    SDL_SetRenderDrawColor(renderer, _r, _g, _b, _a);
-    float r2 = _radius * _radius;
-    for (float dy = -_radius; dy <= _radius; dy += 1.0f) {
-        float dx = Math::Sqrt(r2 - dy * dy);
-        SDL_FRect rct{_x - dx, _y + dy, dx * 2.0f, 1.0f};
-        SDL_RenderFillRect(renderer, &rct);
+void DrawComponent::BuildGeometry() {
+    for (size_t i = 0; i < mLines.x1.size(); ++i) {
+        const SDL_Color& c = mLines.color[i];
+        mGeometry.AddLine(mLines.x1[i], mLines.y1[i], mLines.x2[i], mLines.y2[i],
+                          static_cast<float>(mLines.thickness[i]), GeometryBatch::ToFColor(c.r, c.g, c.b, c.a));
+    }
+    for (size_t i = 0; i < mRects.rect.size(); ++i) {
+        const SDL_Color& c = mRects.color[i];
+        mGeometry.AddRect(mRects.rect[i], GeometryBatch::ToFColor(c.r, c.g, c.b, c.a));
+    }
+    for (size_t i = 0; i < mOutlineRects.rect.size(); ++i) {
+        const SDL_Color& c = mOutlineRects.color[i];
+        mGeometry.AddOutlineRect(mOutlineRects.rect[i], GeometryBatch::ToFColor(c.r, c.g, c.b, c.a));
+    }
+    const CircleAtlas& atlas = gGame.GetCircleAtlas();
+    for (size_t i = 0; i < mCircles.cx.size(); ++i) {
+        const SDL_Color& c = mCircles.color[i];
+        const SDL_FColor color = GeometryBatch::ToFColor(c.r, c.g, c.b, c.a);
+        SDL_FRect dst, uv;
+        if (atlas.Quad(mCircles.cx[i], mCircles.cy[i], mCircles.radius[i], dst, uv))
+            mSprites.AddQuad(dst, uv, color);
+        else
+            // no atlas (texture creation failed): tessellate instead
+            mGeometry.AddCircle(mCircles.cx[i], mCircles.cy[i], mCircles.radius[i], color);
     }
 }
@@ -4,10 +4,11 @@
 
 #ifndef RELATIVITY_SHAPECOMPONENT_H
 #define RELATIVITY_SHAPECOMPONENT_H
-#include <memory>
 #include <string>
 #include <vector>
 #include "Component.h"
+#include "GeometryBatch.h"
+#include "GlyphAtlas.h"
 #include "SDL3/SDL_render.h"
 
 
@@ -19,70 +20,106 @@ protected:
     void HandleUpdate(float deltaTime) override;
     void HandleRender() override;
 
-    friend class Actor;
+    // constructed and destroyed in place by its pool in Game
+    template <typename, size_t> friend class Pool;
 public:
     template <typename T>
     static std::string FormatString(const char* fmt, T val);
     void AddText(float x, float y, std::string_view txt, float scale = 1.0f);
+    // interned text (GlyphAtlas::Intern): no copy, just the id
+    void AddText(float x, float y, GlyphAtlas::Label label, float scale = 1.0f);
     void AddFilledCircle(float cx, float cy, float radius, Uint8 r, Uint8 g,Uint8 b,Uint8 a);
     void AddLine(float x1, float y1, float x2, float y2, Uint8 r, Uint8 g,Uint8 b,Uint8 a, int thickness = 1);
     void AddRect(float x, float y, float w, float h, Uint8 r, Uint8 g,Uint8 b,Uint8 a);
     void AddOutlineRect(float x, float y, float w, float h, Uint8 r, Uint8 g,Uint8 b,Uint8 a);
+    // whole texture stretched over dst, tinted by r,g,b and faded by a. drawn before everything else
+    void AddTexture(SDL_Texture* texture, const SDL_FRect& dst, Uint8 r, Uint8 g,Uint8 b,Uint8 a, SDL_BlendMode blend = SDL_BLENDMODE_BLEND);
+    // a batch the caller keeps alive (and typically reuses across frames), drawn right after the textures
+    void AddBatch(const GeometryBatch* batch);
     void AddScaledWidthRect(float x, float y, float maxW, float h, float pct, Uint8 r, Uint8 g,Uint8 b,Uint8 a, std::string_view endMarker = "", float pad = 0.0f, float textScale = 1.0f, bool reversed = false);
     void AddScaledHeightRect(float x, float y, float w, float maxH, float pct, Uint8 r, Uint8 g,Uint8 b,Uint8 a, std::string_view endMarker = "", float pad = 0.0f, float textScale = 1.0f, bool reversed = false);
 
     void SetColor(Uint8 r, Uint8 g, Uint8 b, Uint8 a) const;
+    // everything this component draws is clipped to rect; nullptr draws unclipped again
+    void SetClipRect(const SDL_Rect* rect);
 
-    struct Shape {
-        virtual ~Shape() = default;
-        float _x, _y;
-        Uint8 _r, _g, _b, _a;
-        virtual void Draw(SDL_Renderer* renderer) = 0;
-        Shape(float x, float y, Uint8 r, Uint8 g, Uint8 b, Uint8 a) :
-        _x(x), _y(y), _r(r), _g(g), _b(b), _a(a)
-        {}
+private:
+    // typed command buffers, structure-of-arrays. Add* appends, HandleRender walks each type in a
+    // tight loop and then clears them — clear() keeps capacity, so steady-state frames don't allocate
+    struct LineBuffer {
+        std::vector<float> x1, y1, x2, y2;
+        std::vector<int> thickness;
+        std::vector<SDL_Color> color;
+        void Clear();
     };
-    struct Rect : Shape {
-        float _w, _h;
-        Rect(float x, float y, float w, float h, Uint8 r, Uint8 g, Uint8 b, Uint8 a):
-        Shape(x, y, r, g, b, a), _w(w), _h(h)
-        {}
-        void Draw(SDL_Renderer* renderer) override;
+    struct CircleBuffer {
+        std::vector<float> cx, cy, radius;
+        std::vector<SDL_Color> color;
+        void Clear();
     };
-    struct Text : Shape {
-        float _scale;
-        std::string _text;
-        Text(float x, float y, float scale, std::string txt, Uint8 r, Uint8 g, Uint8 b, Uint8 a):
-        Shape(x, y, r, g, b, a), _scale(scale), _text(std::move(txt))
-        {}
-        void Draw(SDL_Renderer* renderer) override;
+    struct RectBuffer {
+        std::vector<SDL_FRect> rect;
+        std::vector<SDL_Color> color;
+        void Clear();
     };
-    struct OutlineRect : Shape {
-        float _w, _h;
-        OutlineRect(float x, float y, float w, float h, Uint8 r, Uint8 g, Uint8 b, Uint8 a):
-        Shape(x, y, r, g, b, a), _w(w), _h(h)
-        {}
-        void Draw(SDL_Renderer* renderer) override;
+    struct TextureBuffer {
+        std::vector<SDL_Texture*> texture;
+        std::vector<SDL_FRect> dst;
+        std::vector<SDL_Color> color;
+        std::vector<SDL_BlendMode> blend;
+        void Clear();
     };
-    struct LineSegment : Shape {
-        float _x2, _y2;
-        int _thickness;
-        LineSegment(float x1, float y1, float x2, float y2, Uint8 r, Uint8 g, Uint8 b, Uint8 a, int thickness = 1):
-        Shape(x1, y1, r, g, b, a), _x2(x2), _y2(y2), _thickness(thickness)
-        {}
-        void Draw(SDL_Renderer* renderer) override;
+    struct TextBuffer {
+        std::vector<float> x, y, scale;
+        std::vector<SDL_Color> color;
+        // interned text by id, or NO_LABEL and the text is in the char arena (nul-terminated, indexed by offset)
+        std::vector<GlyphAtlas::Label> label;
+        std::vector<size_t> offset;
+        std::string chars;
+        void Clear();
     };
-    struct Circle : Shape {
-        float _radius;
-        Circle(float cx, float cy, float radius, Uint8 r, Uint8 g, Uint8 b, Uint8 a):
-        Shape(cx, cy, r, g, b, a), _radius(radius)
-        {}
-        void Draw(SDL_Renderer* renderer) override;
+
+public:
+    // a standalone slice of circle and label commands that doesn't touch the renderer, so worker threads
+    // can each fill their own. Append()ing slices in a fixed order queues exactly what the same Add* calls
+    // made serially in that order would have
+    class Commands {
+    public:
+        void AddFilledCircle(float cx, float cy, float radius, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+        void AddText(float x, float y, GlyphAtlas::Label label, float scale = 1.0f);
+        void Clear();
+    private:
+        friend class DrawComponent;
+        CircleBuffer circles;
+        TextBuffer   texts;
     };
+    void Append(const Commands& commands);
 
 private:
+    // tessellate lines and rects into mGeometry, circles into mSprites
+    void BuildGeometry();
+    void DrawTextures() const;
+    // lay every label out as glyph quads into mTextBatch and draw them in one call
+    void DrawTexts();
+    [[nodiscard]] std::string_view TextAt(size_t i) const;
+
     SDL_Renderer* mRenderer = nullptr;
-    std::vector<std::unique_ptr<Shape>> mShapes;
+    SDL_Rect      mClip{};
+    bool          mClipped = false;
+    // drawn in this order: textures, external batches, lines, rects, outline rects, circles, text
+    TextureBuffer mTextures;
+    std::vector<const GeometryBatch*> mBatches;
+    LineBuffer   mLines;
+    RectBuffer   mRects;
+    RectBuffer   mOutlineRects;
+    CircleBuffer mCircles;
+    TextBuffer   mTexts;
+    // lines and rects for the frame, submitted with one SDL_RenderGeometry call
+    GeometryBatch mGeometry;
+    // circles as tinted quads over the shared circle atlas, one more call
+    GeometryBatch mSprites;
+    // text as quads over the shared glyph atlas, the last call
+    GeometryBatch mTextBatch;
 };
 
 template<typename T>
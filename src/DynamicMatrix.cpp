@@ -3,11 +3,51 @@
 //
 
 #include "DynamicMatrix.h"
+#include <atomic>
 #include <stdexcept>
 #include <string>
 
+namespace {
+    std::atomic<uint64_t> gBuffers{0}, gBytes{0};
+    thread_local DynamicMatrix::StorageCounters tStorage;
+
+    void CountBuffer(const size_t floats) {
+        if (floats == 0) return;
+        const uint64_t bytes = floats * sizeof(float);
+        gBuffers.fetch_add(1, std::memory_order_relaxed);
+        gBytes.fetch_add(bytes, std::memory_order_relaxed);
+        ++tStorage.buffers;
+        tStorage.bytes += bytes;
+    }
+}
+
 DynamicMatrix::DynamicMatrix(const size_t rows, const size_t cols, const float init)
-    : mData(rows * cols, init), mRows(rows), mCols(cols) {}
+    : mData(rows * cols, init), mRows(rows), mCols(cols) {
+    CountBuffer(mData.size());
+}
+
+DynamicMatrix::DynamicMatrix(const DynamicMatrix& other)
+    : mData(other.mData), mRows(other.mRows), mCols(other.mCols) {
+    CountBuffer(mData.size());
+}
+
+DynamicMatrix& DynamicMatrix::operator=(const DynamicMatrix& other) {
+    if (this == &other) return *this;
+    // vector assignment reuses our buffer when it's big enough
+    if (mData.capacity() < other.mData.size()) CountBuffer(other.mData.size());
+    mData = other.mData;
+    mRows = other.mRows;
+    mCols = other.mCols;
+    return *this;
+}
+
+DynamicMatrix::StorageCounters DynamicMatrix::Storage() {
+    return {gBuffers.load(std::memory_order_relaxed), gBytes.load(std::memory_order_relaxed)};
+}
+
+DynamicMatrix::StorageCounters DynamicMatrix::ThreadStorage() {
+    return tStorage;
+}
 
 float& DynamicMatrix::at(size_t r, size_t c) {
     // slick
@@ -30,12 +70,14 @@ DynamicMatrix DynamicMatrix::operator*(const DynamicMatrix& other) const {
     DynamicMatrix result(mRows, other.mCols);
     // for each row
     for (size_t i = 0; i < mRows; i++)
-        // iterate over other's columns
-        for (size_t j = 0; j < other.mCols; j++)
-            // and finally the shared dimension (their rows, our cols)
-            for (size_t k = 0; k < mCols; k++)
-                // dot product
-                result.at(i, j) += at(i, k) * other.at(k, j);
+        // walk the shared dimension (their rows, our cols) in the middle...
+        for (size_t k = 0; k < mCols; k++) {
+            const float a = at(i, k);
+            // ...so the inner loop streams along rows of other and result instead of striding down columns
+            // (each result(i, j) still sums over k in order, so the answer is unchanged)
+            for (size_t j = 0; j < other.mCols; j++)
+                result.at(i, j) += a * other.at(k, j);
+        }
     return result;
 }
 
@@ -71,6 +113,15 @@ DynamicMatrix DynamicMatrix::Transpose() const {
     return result;
 }
 
+DynamicMatrix DynamicMatrix::Reshaped(const size_t rows, const size_t cols) const {
+    if (rows * cols != mRows * mCols)
+        throw std::runtime_error("Reshape: " + std::to_string(mRows) + "x" + std::to_string(mCols) +
+            " does not fit " + std::to_string(rows) + "x" + std::to_string(cols));
+    DynamicMatrix result(rows, cols);
+    result.mData = mData;
+    return result;
+}
+
 // element-wise multiply
 DynamicMatrix DynamicMatrix::HadamardProduct(const DynamicMatrix& other) const {
     if (mRows != other.mRows || mCols != other.mCols)
@@ -100,3 +151,47 @@ DynamicMatrix DynamicMatrix::Apply(const std::function<float(float)>& fn) const
             result.at(i, j) = fn(at(i, j));
     return result;
 }
+
+std::vector<size_t> DynamicMatrix::NonZeroRows() const {
+    std::vector<size_t> rows;
+    for (size_t r = 0; r < mRows; r++) {
+        for (size_t c = 0; c < mCols; c++) {
+            if (at(r, c) != 0.0f) {
+                rows.push_back(r);
+                break;
+            }
+        }
+    }
+    return rows;
+}
+
+// outer-product style: result[r][j] = sum_k this[r][k] * other[j][k], for r in rows only
+DynamicMatrix DynamicMatrix::MultiplyTransposedRows(const DynamicMatrix& other, const std::vector<size_t>& rows) const {
+    if (mCols != other.mCols)
+        throw std::runtime_error("Gathered multiply: incompatible shapes (" +
+            std::to_string(mRows) + "x" + std::to_string(mCols) + ") * (" +
+            std::to_string(other.mRows) + "x" + std::to_string(other.mCols) + ")^T");
+
+    DynamicMatrix result(mRows, other.mRows);
+    for (const size_t r : rows)
+        for (size_t j = 0; j < other.mRows; j++)
+            for (size_t k = 0; k < mCols; k++)
+                result.at(r, j) += at(r, k) * other.at(j, k);
+    return result;
+}
+
+// result[c][j] = sum_{k in rows} this[k][c] * other[k][j]
+DynamicMatrix DynamicMatrix::TransposeMultiplyRows(const DynamicMatrix& other, const std::vector<size_t>& rows) const {
+    if (mRows != other.mRows)
+        throw std::runtime_error("Gathered multiply: incompatible shapes (" +
+            std::to_string(mRows) + "x" + std::to_string(mCols) + ")^T * (" +
+            std::to_string(other.mRows) + "x" + std::to_string(other.mCols) + ")");
+
+    DynamicMatrix result(mCols, other.mCols);
+    // walk our rows contiguously, scattering into the result
+    for (const size_t k : rows)
+        for (size_t c = 0; c < mCols; c++)
+            for (size_t j = 0; j < other.mCols; j++)
+                result.at(c, j) += at(k, c) * other.at(k, j);
+    return result;
+}
@@ -5,6 +5,7 @@
 #ifndef NEURAL_NETWORK_CIRCUIT_VISUALIZATION_DYNAMICMATRIX_H
 #define NEURAL_NETWORK_CIRCUIT_VISUALIZATION_DYNAMICMATRIX_H
 
+#include <cstdint>
 #include <vector>
 #include <functional>
 
@@ -14,12 +15,31 @@ class DynamicMatrix {
 
 public:
     DynamicMatrix(size_t rows, size_t cols, float init = 0.0f);
+    // copies are counted (see Storage); moves just hand the buffer over
+    DynamicMatrix(const DynamicMatrix& other);
+    DynamicMatrix& operator=(const DynamicMatrix& other);
+    DynamicMatrix(DynamicMatrix&&) noexcept = default;
+    DynamicMatrix& operator=(DynamicMatrix&&) noexcept = default;
+
+    // storage buffers allocated so far, by construction or by a copy that needed more room.
+    // process-wide, or just the calling thread's; the allocation report breaks these out of the heap totals
+    struct StorageCounters {
+        uint64_t buffers = 0;
+        uint64_t bytes   = 0;
+    };
+    static StorageCounters Storage();
+    static StorageCounters ThreadStorage();
 
     float& at(size_t r, size_t c);
     [[nodiscard]] float at(size_t r, size_t c) const;
 
     [[nodiscard]] size_t Rows() const { return mRows; }
     [[nodiscard]] size_t Cols() const { return mCols; }
+    [[nodiscard]] size_t Size() const { return mData.size(); }
+
+    // raw row-major storage, for kernels that run over the whole matrix at once
+    float* Data() { return mData.data(); }
+    [[nodiscard]] const float* Data() const { return mData.data(); }
 
     DynamicMatrix operator*(const DynamicMatrix& other) const;
     DynamicMatrix operator+(const DynamicMatrix& other) const;
@@ -28,8 +48,19 @@ public:
     DynamicMatrix Apply(const std::function<float(float)>& fn) const;
 
     DynamicMatrix Transpose() const;
+    // same values, new shape (rows*cols must match), read row-major
+    [[nodiscard]] DynamicMatrix Reshaped(size_t rows, size_t cols) const;
     DynamicMatrix HadamardProduct(const DynamicMatrix& other) const;
     DynamicMatrix operator-(const DynamicMatrix& other) const;
+
+    // indices of rows that hold at least one nonzero value
+    [[nodiscard]] std::vector<size_t> NonZeroRows() const;
+
+    // gathered kernels: only the listed rows of *this take part, everything else is treated as zero
+    // this * other^T, computing just the listed rows of the result (the rest stay 0)
+    [[nodiscard]] DynamicMatrix MultiplyTransposedRows(const DynamicMatrix& other, const std::vector<size_t>& rows) const;
+    // this^T * other, summing over just the listed rows of both (no transpose copy)
+    [[nodiscard]] DynamicMatrix TransposeMultiplyRows(const DynamicMatrix& other, const std::vector<size_t>& rows) const;
 };
 
 #endif //NEURAL_NETWORK_CIRCUIT_VISUALIZATION_DYNAMICMATRIX_H
@@ -0,0 +1,19 @@
+//
+// Created by Ben Meyers on 3/17/26.
+//
+
+#include "EdgeList.h"
+
+void EdgeList::Configure(EdgeCull mode, size_t k, float threshold) {
+    // new settings make the current cut stale whatever the weights do
+    if (mode != mMode || k != mK || threshold != mThreshold) mBuilt = false;
+    mMode = mode;
+    mK = k;
+    mThreshold = threshold;
+}
+
+size_t EdgeList::Count() const {
+    size_t n = 0;
+    for (const auto& row : mRows) n += row.size();
+    return n;
+}
@@ -0,0 +1,91 @@
+//
+// Created by Ben Meyers on 3/17/26.
+//
+
+#ifndef NEURAL_NETWORK_CIRCUIT_VISUALIZATION_EDGELIST_H
+#define NEURAL_NETWORK_CIRCUIT_VISUALIZATION_EDGELIST_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// which of a Dense layer's edges are worth drawing
+// All = every weight, TopK = the k strongest incoming edges of each neuron,
+// Threshold = every edge with |w| >= threshold * (largest |w| in the layer)
+enum class EdgeCull {All, TopK, Threshold};
+
+// Compact per-neuron list of a layer's visible edges, kept by the network next to the weights.
+// Cut on demand (NeuralNetwork::RefreshEdges) rather than by every training step, so the renderer
+// can walk visible edges instead of every parameter without training paying for it.
+class EdgeList {
+public:
+    struct Edge {
+        uint32_t in;    // source neuron (weight column)
+        float weight;   // as the forward pass sees it
+    };
+
+    void Configure(EdgeCull mode, size_t k, float threshold);
+
+    // cut every row for the weights at `version`. weightAt is any callable (float)(size_t out, size_t in);
+    // maxAbs is the layer's largest |w|, which a threshold is relative to
+    template<typename F>
+    void Rebuild(size_t outCount, size_t inCount, float maxAbs, uint64_t version, F weightAt);
+    // whether this was cut for the weights at `version`
+    [[nodiscard]] bool Current(uint64_t version) const { return mBuilt && mVersion == version; }
+
+    // kept edges into neuron `out`, weakest first
+    [[nodiscard]] const std::vector<Edge>& Row(size_t out) const { return mRows[out]; }
+    [[nodiscard]] size_t Rows() const { return mRows.size(); }
+    [[nodiscard]] size_t Count() const;
+    [[nodiscard]] EdgeCull Mode() const { return mMode; }
+
+private:
+    EdgeCull mMode = EdgeCull::All;
+    size_t   mK = 0;
+    float    mThreshold = 0.0f;
+    size_t   mInCount = 0;
+    uint64_t mVersion = 0;
+    bool     mBuilt = false;
+
+    std::vector<std::vector<Edge>> mRows;
+
+    template<typename F>
+    void BuildRow(size_t r, float cut, F weightAt);
+};
+
+template<typename F>
+void EdgeList::BuildRow(size_t r, float cut, F weightAt) {
+    std::vector<Edge>& row = mRows[r];
+    row.clear();
+    if (mMode == EdgeCull::Threshold) {
+        for (size_t c = 0; c < mInCount; ++c) {
+            const float w = weightAt(r, c);
+            if (std::abs(w) >= cut) row.push_back({static_cast<uint32_t>(c), w});
+        }
+    } else {
+        for (size_t c = 0; c < mInCount; ++c)
+            row.push_back({static_cast<uint32_t>(c), weightAt(r, c)});
+        if (mMode == EdgeCull::TopK && mK < row.size()) {
+            // strongest k to the front, then drop the rest (capacity stays for next time)
+            std::nth_element(row.begin(), row.begin() + static_cast<std::ptrdiff_t>(mK), row.end(),
+                             [](const Edge& a, const Edge& b) { return std::abs(a.weight) > std::abs(b.weight); });
+            row.resize(mK);
+        }
+    }
+    // weakest first so a renderer drawing in order leaves the strong edges on top
+    std::sort(row.begin(), row.end(), [](const Edge& a, const Edge& b) { return std::abs(a.weight) < std::abs(b.weight); });
+}
+
+template<typename F>
+void EdgeList::Rebuild(size_t outCount, size_t inCount, float maxAbs, uint64_t version, F weightAt) {
+    mInCount = inCount;
+    mRows.resize(outCount);
+    const float cut = mThreshold * maxAbs;
+    for (size_t r = 0; r < outCount; ++r) BuildRow(r, cut, weightAt);
+    mVersion = version;
+    mBuilt = true;
+}
+
+#endif //NEURAL_NETWORK_CIRCUIT_VISUALIZATION_EDGELIST_H
@@ -0,0 +1,31 @@
+//
+// Created by Ben Meyers on 3/16/26.
+//
+
+#include "EdgeLod.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+void EdgeLod::ChooseBins(int inCount, int outCount, float heightPx, size_t edgeBudget, int& inBins, int& outBins) {
+    // pixel density: how many bins the column height can actually separate
+    const int maxBins = std::max(1, static_cast<int>(heightPx / MIN_BIN_PIXELS));
+    inBins  = std::clamp(inCount,  1, maxBins);
+    outBins = std::clamp(outCount, 1, maxBins);
+
+    // edge budget: shrink both sides by the same factor so the bundle grid keeps its aspect
+    const auto edges = static_cast<double>(inBins) * static_cast<double>(outBins);
+    if (edgeBudget > 0 && edges > static_cast<double>(edgeBudget)) {
+        const double scale = std::sqrt(static_cast<double>(edgeBudget) / edges);
+        inBins  = std::max(1, static_cast<int>(inBins  * scale));
+        outBins = std::max(1, static_cast<int>(outBins * scale));
+    }
+}
+
+void EdgeLod::Finish(EdgeBins& bins) {
+    bins.order.resize(bins.meanAbs.size());
+    std::iota(bins.order.begin(), bins.order.end(), 0);
+    std::sort(bins.order.begin(), bins.order.end(),
+              [&bins](int a, int b) { return bins.meanAbs[a] < bins.meanAbs[b]; });
+    bins.maxMeanAbs = bins.meanAbs.empty() ? 0.0f : bins.meanAbs[bins.order.back()];
+}
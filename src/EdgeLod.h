@@ -0,0 +1,88 @@
+//
+// Created by Ben Meyers on 3/16/26.
+//
+
+#ifndef NEURAL_NETWORK_CIRCUIT_VISUALIZATION_EDGELOD_H
+#define NEURAL_NETWORK_CIRCUIT_VISUALIZATION_EDGELOD_H
+
+#include <cstddef>
+#include <vector>
+
+// Level of detail for the in x out edges between two columns.
+// Neurons are grouped into contiguous bins (neuron n of count goes to bin n * bins / count)
+// and every edge is folded into its bin pair, so a layer draws bins_in * bins_out bundles instead of in * out lines.
+struct EdgeBins {
+    int inCount = 0, outCount = 0;
+    int inBins = 0,  outBins = 0;
+    std::vector<float> meanAbs;     // [outBins x inBins], row-major: mean |value| of the edges in the bundle
+    std::vector<float> meanSigned;  // same layout, mean signed value (its sign picks the color)
+    std::vector<int>   order;       // bundle indices by ascending meanAbs, so strong bundles are drawn last (on top)
+    float maxMeanAbs = 0.0f;
+
+    [[nodiscard]] bool Matches(int in, int out, int bIn, int bOut) const {
+        return in == inCount && out == outCount && bIn == inBins && bOut == outBins;
+    }
+    [[nodiscard]] bool FullDetail() const { return inBins == inCount && outBins == outCount; }
+};
+
+namespace EdgeLod {
+    // a bin must be at least this tall on screen; below it neighbouring neurons' lines merge into mush anyway
+    constexpr float MIN_BIN_PIXELS = 4.0f;
+
+    // bins per side for a column pair drawn heightPx tall: no more than the pixels can separate,
+    // and no more than edgeBudget bundles in total. returns in/out counts unchanged when everything fits
+    void ChooseBins(int inCount, int outCount, float heightPx, size_t edgeBudget, int& inBins, int& outBins);
+
+    // first neuron of `bin` (bin == bins gives count, so [First(b), First(b+1)) is the bin's range)
+    inline int First(int bin, int bins, int count) {
+        return static_cast<int>((static_cast<long long>(bin) * count + bins - 1) / bins);
+    }
+
+    // fold value(out, in) over every edge into bins. value is any callable (float)(size_t out, size_t in)
+    template<typename F>
+    void Aggregate(EdgeBins& bins, int inCount, int outCount, int inBins, int outBins, F value);
+    // sorts bins.order and finds maxMeanAbs once meanAbs is filled
+    void Finish(EdgeBins& bins);
+}
+
+template<typename F>
+void EdgeLod::Aggregate(EdgeBins& bins, int inCount, int outCount, int inBins, int outBins, F value) {
+    bins.inCount = inCount;
+    bins.outCount = outCount;
+    bins.inBins = inBins;
+    bins.outBins = outBins;
+    const size_t n = static_cast<size_t>(inBins) * static_cast<size_t>(outBins);
+    bins.meanAbs.assign(n, 0.0f);
+    bins.meanSigned.assign(n, 0.0f);
+
+    // walk out rows in order (row-major weights), accumulating into the current out bin's row of bundles
+    for (int bo = 0; bo < outBins; ++bo) {
+        float* absRow = bins.meanAbs.data() + static_cast<size_t>(bo) * inBins;
+        float* sgnRow = bins.meanSigned.data() + static_cast<size_t>(bo) * inBins;
+        const int j0 = First(bo, outBins, outCount), j1 = First(bo + 1, outBins, outCount);
+        for (int j = j0; j < j1; ++j) {
+            for (int bi = 0; bi < inBins; ++bi) {
+                const int i0 = First(bi, inBins, inCount), i1 = First(bi + 1, inBins, inCount);
+                float sa = 0.0f, ss = 0.0f;
+                for (int i = i0; i < i1; ++i) {
+                    const float v = value(static_cast<size_t>(j), static_cast<size_t>(i));
+                    sa += v < 0.0f ? -v : v;
+                    ss += v;
+                }
+                absRow[bi] += sa;
+                sgnRow[bi] += ss;
+            }
+        }
+        // sums -> means
+        for (int bi = 0; bi < inBins; ++bi) {
+            const auto edges = static_cast<float>((j1 - j0) * (First(bi + 1, inBins, inCount) - First(bi, inBins, inCount)));
+            if (edges > 0.0f) {
+                absRow[bi] /= edges;
+                sgnRow[bi] /= edges;
+            }
+        }
+    }
+    Finish(bins);
+}
+
+#endif //NEURAL_NETWORK_CIRCUIT_VISUALIZATION_EDGELOD_H
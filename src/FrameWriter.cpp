@@ -0,0 +1,93 @@
+//
+// Created by Ben Meyers on 3/24/26.
+//
+
+#include "FrameWriter.h"
+#include <cstdio>
+#include "Trace.h"
+
+FrameWriter::~FrameWriter() {
+    Finish();
+}
+
+bool FrameWriter::Start(std::string dir, Format format, size_t threads, size_t maxQueued) {
+    Finish();
+    mDir       = std::move(dir);
+    mFormat    = format;
+    mMaxQueued = maxQueued == 0 ? 1 : maxQueued;
+    mStop      = false;
+    mWritten.store(0, std::memory_order_relaxed);
+    mFailed.store(0, std::memory_order_relaxed);
+    if (!SDL_CreateDirectory(mDir.c_str())) return false;
+    if (threads == 0) threads = 1;
+    for (size_t i = 0; i < threads; ++i)
+        mThreads.emplace_back(&FrameWriter::Worker, this);
+    return true;
+}
+
+void FrameWriter::Submit(SDL_Surface* frame, uint64_t index) {
+    if (!frame) {
+        mFailed.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    {
+        std::unique_lock lock(mMutex);
+        mHasRoom.wait(lock, [this] { return mQueue.size() < mMaxQueued; });
+        mQueue.push_back({frame, index});
+    }
+    mHasWork.notify_one();
+}
+
+void FrameWriter::Finish() {
+    {
+        std::lock_guard lock(mMutex);
+        mStop = true;
+    }
+    mHasWork.notify_all();
+    // workers drain the queue before they look at mStop
+    for (std::thread& t : mThreads) t.join();
+    mThreads.clear();
+}
+
+void FrameWriter::Worker() {
+    NN_TRACE_THREAD("frame writer");
+    for (;;) {
+        Job job{};
+        {
+            std::unique_lock lock(mMutex);
+            mHasWork.wait(lock, [this] { return mStop || !mQueue.empty(); });
+            if (mQueue.empty()) return;
+            job = mQueue.front();
+            mQueue.pop_front();
+        }
+        mHasRoom.notify_one();
+        if (Write(job.frame, job.index))
+            mWritten.fetch_add(1, std::memory_order_relaxed);
+        else
+            mFailed.fetch_add(1, std::memory_order_relaxed);
+        SDL_DestroySurface(job.frame);
+    }
+}
+
+bool FrameWriter::Write(SDL_Surface* frame, uint64_t index) const {
+    NN_TRACE_SCOPE("FrameWriter::Write");
+    char path[512];
+    std::snprintf(path, sizeof(path), "%s/frame_%06llu.%s", mDir.c_str(), static_cast<unsigned long long>(index),
+                  mFormat == Format::BMP ? "bmp" : "rgba");
+    if (mFormat == Format::BMP) return SDL_SaveBMP(frame, path);
+
+    // read-back comes in the renderer's format, so pin it to byte-order RGBA first
+    SDL_Surface* rgba = frame->format == SDL_PIXELFORMAT_RGBA32 ? frame : SDL_ConvertSurface(frame, SDL_PIXELFORMAT_RGBA32);
+    if (!rgba) return false;
+    bool ok = false;
+    if (std::FILE* f = std::fopen(path, "wb")) {
+        ok = true;
+        const auto rowBytes = static_cast<size_t>(rgba->w) * 4;
+        const auto* row = static_cast<const unsigned char*>(rgba->pixels);
+        for (int y = 0; y < rgba->h && ok; ++y, row += rgba->pitch)
+            ok = std::fwrite(row, 1, rowBytes, f) == rowBytes;
+        ok = std::fclose(f) == 0 && ok;
+    }
+    if (rgba != frame) SDL_DestroySurface(rgba);
+    return ok;
+}
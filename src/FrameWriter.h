@@ -0,0 +1,66 @@
+//
+// Created by Ben Meyers on 3/24/26.
+//
+
+#ifndef NEURAL_NETWORK_CIRCUIT_VISUALIZATION_FRAMEWRITER_H
+#define NEURAL_NETWORK_CIRCUIT_VISUALIZATION_FRAMEWRITER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SDL3/SDL.h"
+
+// Writes rendered frames to disk on its own worker threads, so the render loop only pays for reading
+// the pixels back. Frames are numbered by the caller and written as <dir>/frame_000123.<ext>, in
+// whatever order the workers finish them.
+class FrameWriter {
+public:
+    enum class Format {
+        BMP,   // SDL_SaveBMP, opens anywhere (ffmpeg -i frame_%06d.bmp ...)
+        RGBA,  // headerless 8-bit RGBA rows, width x height from the log (ffmpeg -f rawvideo -pix_fmt rgba ...)
+    };
+
+    FrameWriter() = default;
+    ~FrameWriter();
+    FrameWriter(const FrameWriter&) = delete;
+    FrameWriter& operator=(const FrameWriter&) = delete;
+
+    // maxQueued bounds the frames read back but not yet written (each one is a full-size copy)
+    bool Start(std::string dir, Format format, size_t threads, size_t maxQueued);
+    // takes ownership of the surface. blocks while maxQueued frames are already waiting
+    void Submit(SDL_Surface* frame, uint64_t index);
+    // waits until every submitted frame is on disk, then stops the workers
+    void Finish();
+
+    [[nodiscard]] uint64_t Written() const { return mWritten.load(std::memory_order_relaxed); }
+    [[nodiscard]] uint64_t Failed() const { return mFailed.load(std::memory_order_relaxed); }
+
+private:
+    struct Job {
+        SDL_Surface* frame;
+        uint64_t     index;
+    };
+    void Worker();
+    bool Write(SDL_Surface* frame, uint64_t index) const;
+
+    std::string mDir;
+    Format      mFormat = Format::BMP;
+    size_t      mMaxQueued = 1;
+
+    std::vector<std::thread> mThreads;
+    std::mutex               mMutex;
+    std::condition_variable  mHasWork;  // workers: a job arrived (or stop)
+    std::condition_variable  mHasRoom;  // producer: the queue dropped below maxQueued
+    std::deque<Job>          mQueue;
+    bool                     mStop = false;
+
+    std::atomic<uint64_t> mWritten{0};
+    std::atomic<uint64_t> mFailed{0};
+};
+
+#endif //NEURAL_NETWORK_CIRCUIT_VISUALIZATION_FRAMEWRITER_H
@@ -1,12 +1,19 @@
 #include "Game.h"
 
+#include <cstdlib>
+#include <exception>
 #include <iostream>
+#include <sstream>
+#include <string_view>
+#include <type_traits>
 
 #include "Actor.h"
 #include "Component.h"
 #include "DrawComponent.h"
 #include "Line.h"
 #include "NeuralNetworkActor.h"
+#include "PerfHud.h"
+#include "Trace.h"
 Game gGame;
 #include "NeuralNetwork.h"
 Game::Game()
@@ -21,43 +28,259 @@ Game::Game()
 	mPreviousTime = 0;
 }
 
+bool Game::ParseArgs(int argc, char** argv)
+{
+	auto usage = [argv] {
+		SDL_Log("usage: %s [--headless FRAMES [--out DIR] [--fps FPS] [--format bmp|rgba] [--writers N]] [--train]\n"
+		        "       %s --bench N,N,... [--bench-frames N] [--bench-warmup N] [--bench-columns N] [--bench-out FILE] [--train]\n"
+		        "       %s --pipeline STAGES [--pipeline-steps N] [--pipeline-micro N] [--pipeline-width N] [--pipeline-depth N]",
+		        argv[0], argv[0], argv[0]);
+		return false;
+	};
+	auto count = [](const char* text, auto& out) {
+		char* end = nullptr;
+		const unsigned long long n = std::strtoull(text, &end, 10);
+		out = static_cast<std::remove_reference_t<decltype(out)>>(n);
+		return end != text && *end == '\0';
+	};
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string_view arg = argv[i];
+		if (arg == "--train")
+		{
+			mHeadless.train = true;
+			continue;
+		}
+		// everything else takes a value
+		if (i + 1 >= argc)
+		{
+			return usage();
+		}
+		const char* value = argv[++i];
+		bool ok = true;
+		if (arg == "--headless")
+		{
+			ok = count(value, mHeadless.frames) && mHeadless.frames > 0;
+		}
+		else if (arg == "--out")
+		{
+			mHeadless.outDir = value;
+		}
+		else if (arg == "--fps")
+		{
+			char* end = nullptr;
+			mHeadless.fps = std::strtof(value, &end);
+			ok = end != value && *end == '\0' && mHeadless.fps > 0.0f;
+		}
+		else if (arg == "--format")
+		{
+			const std::string_view format = value;
+			ok = format == "bmp" || format == "rgba";
+			mHeadless.format = format == "rgba" ? FrameWriter::Format::RGBA : FrameWriter::Format::BMP;
+		}
+		else if (arg == "--writers")
+		{
+			ok = count(value, mHeadless.writers);
+		}
+		else if (arg == "--bench")
+		{
+			ok = RenderBench::ParseSizes(value, mBench.GetOptions().sizes);
+		}
+		else if (arg == "--bench-frames")
+		{
+			ok = count(value, mBench.GetOptions().frames) && mBench.GetOptions().frames > 0;
+		}
+		else if (arg == "--bench-warmup")
+		{
+			ok = count(value, mBench.GetOptions().warmup);
+		}
+		else if (arg == "--bench-columns")
+		{
+			ok = count(value, mBench.GetOptions().columns) && mBench.GetOptions().columns >= 2;
+		}
+		else if (arg == "--bench-out")
+		{
+			mBench.GetOptions().outPath = value;
+		}
+		else if (arg == "--pipeline")
+		{
+			ok = count(value, mPipeline.GetOptions().stages) && mPipeline.GetOptions().stages > 0;
+		}
+		else if (arg == "--pipeline-steps")
+		{
+			ok = count(value, mPipeline.GetOptions().steps) && mPipeline.GetOptions().steps > 0;
+		}
+		else if (arg == "--pipeline-micro")
+		{
+			ok = count(value, mPipeline.GetOptions().micro) && mPipeline.GetOptions().micro > 0;
+		}
+		else if (arg == "--pipeline-width")
+		{
+			ok = count(value, mPipeline.GetOptions().width);
+		}
+		else if (arg == "--pipeline-depth")
+		{
+			ok = count(value, mPipeline.GetOptions().depth) && mPipeline.GetOptions().depth >= 2;
+		}
+		else
+		{
+			ok = false;
+		}
+		if (!ok)
+		{
+			return usage();
+		}
+	}
+	// one offscreen mode at a time
+	if ((mHeadless.frames > 0) + mBench.Enabled() + mPipeline.Enabled() > 1)
+	{
+		return usage();
+	}
+	return true;
+}
+
+bool Game::RunPipelineBench()
+{
+	try
+	{
+		mPipeline.Run(NN_CFG_PATH);
+	}
+	catch (const std::exception& e)
+	{
+		SDL_Log("pipeline benchmark failed: %s", e.what());
+		return false;
+	}
+	return true;
+}
+
 bool Game::Initialize()
 {
-	SDL_SetHint("SDL_MAIN_CALLBACK_RATE", "60");
-	bool sdlInit = SDL_Init(SDL_INIT_AUDIO | SDL_INIT_VIDEO);
-	// fail if SDL init doesn't work
-	if (!sdlInit)
+	NN_TRACE_THREAD("main");
+	if (IsHeadless())
+	{
+		if (!InitializeHeadless())
+		{
+			return false;
+		}
+	}
+	else
+	{
+		SDL_SetHint("SDL_MAIN_CALLBACK_RATE", "60");
+		bool sdlInit = SDL_Init(SDL_INIT_AUDIO | SDL_INIT_VIDEO);
+		// fail if SDL init doesn't work
+		if (!sdlInit)
+		{
+			return false;
+		}
+		// use window constants
+		mSdlWindow = SDL_CreateWindow("NEURAL NETWORK CIRCUITS", WINDOW_WIDTH, WINDOW_HEIGHT, 0);
+		if (mSdlWindow == nullptr)
+		{
+			return false;
+		}
+
+		mSdlRenderer = SDL_CreateRenderer(mSdlWindow, nullptr);
+		if (mSdlRenderer == nullptr)
+		{
+			return false;
+		}
+	}
+	RebuildCircleAtlas();
+	RebuildGlyphAtlas();
+	mThreadPool.Start(ThreadPool::DefaultWorkers());
+
+	// init actors!
+	LoadData();
+	return true;
+}
+
+bool Game::InitializeHeadless()
+{
+	// unpaced: the next iteration starts as soon as this frame is handed to the writers
+	SDL_SetHint("SDL_MAIN_CALLBACK_RATE", "0");
+	// the software renderer needs no video driver, so no display either
+	if (!SDL_Init(0))
 	{
 		return false;
 	}
-	// use window constants
-	mSdlWindow = SDL_CreateWindow("NEURAL NETWORK CIRCUITS", PLOT_WIDTH, WINDOW_HEIGHT, 0);
-	if (mSdlWindow == nullptr)
+	const int w = static_cast<int>(WINDOW_WIDTH), h = static_cast<int>(WINDOW_HEIGHT);
+	mOffscreen = SDL_CreateSurface(w, h, SDL_PIXELFORMAT_RGBA32);
+	if (mOffscreen == nullptr)
 	{
 		return false;
 	}
-
-	mSdlRenderer = SDL_CreateRenderer(mSdlWindow, nullptr);
+	mSdlRenderer = SDL_CreateSoftwareRenderer(mOffscreen);
 	if (mSdlRenderer == nullptr)
 	{
 		return false;
 	}
 
-	// init actors!
-	LoadData();
+	mHeadlessStart = SDL_GetPerformanceCounter();
+	if (mBench.Enabled())
+	{
+		return true;
+	}
+
+	const size_t spare = ThreadPool::DefaultWorkers();
+	const size_t writers = mHeadless.writers > 0 ? mHeadless.writers : (spare > 0 ? spare : 1);
+	if (!mFrameWriter.Start(mHeadless.outDir, mHeadless.format, writers, MAX_QUEUED_FRAMES))
+	{
+		SDL_Log("can't write frames to %s: %s", mHeadless.outDir.c_str(), SDL_GetError());
+		return false;
+	}
+	SDL_Log("headless: %llu frames, %dx%d at %.2f fps, %zu writers -> %s/",
+	        static_cast<unsigned long long>(mHeadless.frames), w, h, static_cast<double>(mHeadless.fps), writers,
+	        mHeadless.outDir.c_str());
 	return true;
 }
 
+void Game::CaptureFrame()
+{
+	NN_TRACE_SCOPE("CaptureFrame");
+	// flushes the queued draws into mOffscreen and copies them out; the writers own the copy from here
+	mFrameWriter.Submit(SDL_RenderReadPixels(mSdlRenderer, nullptr), mFramesRendered);
+	if (++mFramesRendered >= mHeadless.frames)
+	{
+		mContinueRunning = false;
+	}
+}
+
 bool Game::RunIteration()
 {
 	// game loop!
+	NN_TRACE_SCOPE("frame");
+	mProfiler.BeginFrame();
 
 	// get input
-	ProcessInput();
+	{
+		NN_TRACE_SCOPE("ProcessInput");
+		ProcessInput();
+	}
+	mProfiler.EndPhase(Perf::INPUT);
 	// update game objects
-	UpdateGame();
+	{
+		NN_TRACE_SCOPE("UpdateGame");
+		UpdateGame();
+	}
+	mProfiler.EndPhase(Perf::UPDATE);
 	// render
-	GenerateOutput();
+	{
+		NN_TRACE_SCOPE("GenerateOutput");
+		GenerateOutput();
+	}
+	mProfiler.EndPhase(Perf::OUTPUT);
+	// train with whatever the frame has left
+	{
+		NN_TRACE_SCOPE("TrainInBudget");
+		TrainInBudget();
+	}
+	mProfiler.EndPhase(Perf::TRAIN);
+
+	mProfiler.EndFrame();
+	if (mBench.Enabled())
+	{
+		StepBench();
+	}
 	return mContinueRunning;
 }
 
@@ -65,55 +288,174 @@ void Game::Shutdown()
 {
 	// call proper unloaders/destroyers
 	UnloadData();
+	if (mHeadless.frames > 0)
+	{
+		mFrameWriter.Finish();
+		const double seconds = static_cast<double>(SDL_GetPerformanceCounter() - mHeadlessStart) /
+		                       static_cast<double>(SDL_GetPerformanceFrequency());
+		SDL_Log("headless: %llu frames written, %llu failed, in %.2f s (%.1f fps, %.1fx real time)",
+		        static_cast<unsigned long long>(mFrameWriter.Written()),
+		        static_cast<unsigned long long>(mFrameWriter.Failed()), seconds,
+		        seconds > 0.0 ? static_cast<double>(mFramesRendered) / seconds : 0.0,
+		        seconds > 0.0 ? static_cast<double>(mFramesRendered) / mHeadless.fps / seconds : 0.0);
+	}
+	DumpTrace();
+	if (mProfiler.Frames() > 0)
+	{
+		SDL_Log("frames: %llu, %llu skipped as unchanged (%.1f%%)", static_cast<unsigned long long>(mProfiler.Frames()),
+		        static_cast<unsigned long long>(mProfiler.FramesSkipped()),
+		        100.0 * static_cast<double>(mProfiler.FramesSkipped()) / static_cast<double>(mProfiler.Frames()));
+	}
+	SDL_Log("allocations:\n%s", Perf::AllocReport().c_str());
+	mThreadPool.Stop();
+	mCircleAtlas.Destroy();
+	mGlyphAtlas.Destroy();
 	SDL_DestroyRenderer(mSdlRenderer);
-	SDL_DestroyWindow(mSdlWindow);
+	if (mSdlWindow != nullptr)
+	{
+		SDL_DestroyWindow(mSdlWindow);
+	}
+	// after the renderer that draws into it
+	SDL_DestroySurface(mOffscreen);
 	SDL_Quit();
 }
 
 void Game::HandleEvent(const SDL_Event* event)
 {
+	// input, exposure, resizes, device resets: anything from outside gets the next frame drawn
+	mWake = true;
 	// x button
 	if (event->type == SDL_EVENT_QUIT)
 	{
 		mContinueRunning = false;
 	}
+	// the wheel only arrives as events, so it's summed here until the next input pass reads it
+	if (event->type == SDL_EVENT_MOUSE_WHEEL)
+	{
+		mMouseWheel += event->wheel.direction == SDL_MOUSEWHEEL_FLIPPED ? -event->wheel.y : event->wheel.y;
+	}
+	// new output size means new max neuron size; a device reset loses the texture outright
+	if (event->type == SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED || event->type == SDL_EVENT_RENDER_DEVICE_RESET)
+	{
+		RebuildCircleAtlas();
+	}
+	// render-target textures (cached weight layers, the glyph atlas) lose their pixels on either reset
+	if (event->type == SDL_EVENT_RENDER_TARGETS_RESET || event->type == SDL_EVENT_RENDER_DEVICE_RESET)
+	{
+		++mRenderTargetEpoch;
+		RebuildGlyphAtlas();
+	}
+}
+
+void Game::DumpTrace()
+{
+#if NN_TRACING
+	if (Trace::Dump(TRACE_PATH))
+	{
+		SDL_Log("trace written to %s", TRACE_PATH);
+	}
+	else
+	{
+		SDL_Log("couldn't write trace to %s", TRACE_PATH);
+	}
+#endif
+}
+
+void Game::RebuildGlyphAtlas()
+{
+	if (!mGlyphAtlas.Build(mSdlRenderer))
+	{
+		SDL_Log("glyph atlas unavailable, falling back to debug text: %s", SDL_GetError());
+	}
+}
+
+void Game::RebuildCircleAtlas()
+{
+	int w = 0, h = 0;
+	if (!SDL_GetCurrentRenderOutputSize(mSdlRenderer, &w, &h))
+	{
+		w = static_cast<int>(PLOT_WIDTH);
+		h = static_cast<int>(WINDOW_HEIGHT);
+	}
+	// nothing on screen is drawn bigger than a quarter of the short side
+	float maxRadius = static_cast<float>(Math::Min(w, h)) / 4.0f;
+	if (!mCircleAtlas.Build(mSdlRenderer, maxRadius))
+	{
+		SDL_Log("circle atlas unavailable, falling back to tessellated circles: %s", SDL_GetError());
+	}
 }
 
 void Game::DestroyActor(Actor *actor) {
+	for (auto& system : mActorSystems)
+	{
+		if (system->Destroy(actor))
+		{
+			return;
+		}
+	}
+}
 
-		std::erase(mActors, actor);
-		delete actor;
+void Game::DestroyComponent(Component* comp)
+{
+	for (auto& system : mComponentSystems)
+	{
+		if (system->Destroy(comp))
+		{
+			return;
+		}
+	}
+}
 
+void Game::SortDrawList()
+{
+	Pool<DrawComponent>& draws = Components<DrawComponent>().pool;
+	mDrawList.clear();
+	for (uint32_t i = 0; i < draws.End(); ++i)
+	{
+		if (draws.At(i) != nullptr)
+		{
+			mDrawList.push_back(i);
+		}
+	}
+	std::ranges::stable_sort(mDrawList, {}, [&draws](uint32_t i) { return draws.At(i)->GetDrawOrder(); });
+	mDrawOrderDirty = false;
 }
 
 void Game::ProcessInput()
 {
+	// nobody at the keyboard, and the frames shouldn't depend on whoever is
+	if (IsHeadless())
+	{
+		return;
+	}
 	const bool* keyboardState = SDL_GetKeyboardState(nullptr);
 	// esc key can also end game
 	if (keyboardState[SDL_SCANCODE_ESCAPE])
 	{
 		mContinueRunning = false;
 	}
+	// F8 turns skipping unchanged frames on and off
+	LeadingEdge(keyboardState[SDL_SCANCODE_F8], mLastF8, [this] {
+		mIdleSkip = !mIdleSkip;
+		SDL_Log("idle frame skipping %s (%.1f%% of recent frames skipped)", mIdleSkip ? "on" : "off",
+		        static_cast<double>(mProfiler.SkippedPercent()));
+	});
+	// F9 writes out what the trace buffers hold right now
+	LeadingEdge(keyboardState[SDL_SCANCODE_F9], mLastF9, [this] { DumpTrace(); });
+	// F10 logs the allocation report so far
+	LeadingEdge(keyboardState[SDL_SCANCODE_F10], mLastF10, [] { SDL_Log("allocations:\n%s", Perf::AllocReport().c_str()); });
 
 	// mouse
 	SDL_MouseButtonFlags mouseButtons = SDL_GetMouseState(&mMousePos.x, &mMousePos.y);
 
-	for (auto a : mActors) {
-		a->Input(keyboardState, mouseButtons, mMousePos);
+	// systems can be added while they run (a first actor of a new type), so by index
+	for (size_t i = 0, n = mComponentSystems.size(); i < n; ++i) {
+		mComponentSystems[i]->Input(keyboardState, mouseButtons, mMousePos);
 	}
-
-}
-
-void Game::AddRenderable(Component* comp) {
-	const auto it = std::ranges::upper_bound(mRenderables, comp,
-	                                   [](const Component* a, const Component* b) {
-		                                   return a->GetDrawOrder() < b->GetDrawOrder();
-	                                   });
-	mRenderables.insert(it, comp);
-}
-
-void Game::RemoveRenderable(Component* comp) {
-	std::erase(mRenderables, comp);
+	for (size_t i = 0, n = mActorSystems.size(); i < n; ++i) {
+		mActorSystems[i]->Input(keyboardState, mouseButtons, mMousePos);
+	}
+	mMouseWheel = 0.0f;
 }
 
 void Game::LeadingEdge(bool keyBool, bool &lastBool, const std::function<void()> &fn, bool condition) {
@@ -133,12 +475,30 @@ void Game::AddPendingDestroy(class Actor *actor) {
 
 void Game::UpdateGame()
 {
-	// calculate deltatime
-	Uint64 currTimeMs = SDL_GetTicks();
-	Uint64 uIntDiff = currTimeMs - mPreviousTime;
-	mPreviousTime = currTimeMs;
-	float deltaTime = static_cast<float>(uIntDiff) / MS_PER_SEC;
-	deltaTime = Math::Min(MAX_DELTA_TIME, deltaTime);
+	if (IsHeadless())
+	{
+		// one step per frame: frame n always shows time n/fps, however long it took to draw
+		StepSimulation(1.0f / mHeadless.fps);
+		mAlpha = 0.0f;
+		return;
+	}
+
+	// fixed steps for however much time passed; a long stall (dragging the window) is dropped, not replayed
+	Uint64 currTimeNs = SDL_GetTicksNS();
+	Uint64 elapsedNs = currTimeNs - mPreviousTime;
+	mPreviousTime = currTimeNs;
+	mAccumulatorNs += Math::Min(elapsedNs, static_cast<Uint64>(MAX_DELTA_TIME * static_cast<float>(SDL_NS_PER_SECOND)));
+	while (mAccumulatorNs >= FIXED_STEP_NS)
+	{
+		StepSimulation(FIXED_DT);
+		mAccumulatorNs -= FIXED_STEP_NS;
+	}
+	// the frame lands somewhere between two steps; frames that got zero or two steps still move evenly
+	mAlpha = static_cast<float>(mAccumulatorNs) / static_cast<float>(FIXED_STEP_NS);
+}
+
+void Game::StepSimulation(float deltaTime)
+{
 	mDT += deltaTime;
 
 	// 'leading edge' of elapsed eclipsing set duration
@@ -146,13 +506,12 @@ void Game::UpdateGame()
 		mGameDone = true;
 	}
 
-	for (auto actor : mPendingCreate)
-		mActors.emplace_back(actor);
+	// components first, as they were when each actor updated its own
+	for (size_t i = 0, n = mComponentSystems.size(); i < n; ++i)
+		mComponentSystems[i]->Update(deltaTime);
 
-	mPendingCreate.clear();
-
-	for (auto actor : mActors)
-		actor->Update(deltaTime);
+	for (size_t i = 0, n = mActorSystems.size(); i < n; ++i)
+		mActorSystems[i]->Update(deltaTime);
 
 	for (auto actor : mPendingDestroy)
 		DestroyActor(actor);
@@ -160,41 +519,140 @@ void Game::UpdateGame()
 	mPendingDestroy.clear();
 }
 
+void Game::TrainInBudget()
+{
+	// the previous frame ran over: something outside the measured work (present, the OS) needs more room
+	const float overMs = mProfiler.Last().totalMs - FRAME_BUDGET_MS;
+	mBudgetMarginMs = overMs > 0.0f ? Math::Min(mBudgetMarginMs + overMs, FRAME_BUDGET_MS)
+	                                : Math::Max(MIN_BUDGET_MARGIN_MS, mBudgetMarginMs * 0.99f);
+	if (mNN == nullptr || !mNN->GetBudgetedTraining())
+	{
+		return;
+	}
+	mNN->TrainFor(FRAME_BUDGET_MS - mProfiler.ElapsedMs() - mBudgetMarginMs);
+}
+
+bool Game::NeedsRedraw() const
+{
+	// recorded and benchmarked frames are all wanted
+	if (IsHeadless() || !mIdleSkip || mWake)
+	{
+		return true;
+	}
+	return std::ranges::any_of(mActorSystems, [](const auto& system) { return system->AnyDirty(); });
+}
+
 void Game::GenerateOutput()
 {
+	// nothing moved and nothing happened: what was presented last is still right, so leave it on screen
+	if (!NeedsRedraw())
+	{
+		mProfiler.MarkSkipped();
+		return;
+	}
+	mWake = false;
+	for (auto& system : mActorSystems)
+	{
+		system->ClearDirty();
+	}
+
+	Perf::PhaseScope allocPhase(Perf::RENDER);
 	SDL_SetRenderDrawColor(mSdlRenderer, 0, 0, 0, MAX_COLOR);
 	SDL_RenderClear(mSdlRenderer);
 
 	// actors call their own HandleRender, creating shapes
-	for (auto& a : mActors) {
-		a->Render();
+	for (size_t i = 0, n = mActorSystems.size(); i < n; ++i) {
+		mActorSystems[i]->Render();
 	}
 
 	// actual rendering components then draw shapes to SDL in order
-	for (auto& comp : mRenderables) {
-		comp->Render();
+	if (mDrawOrderDirty) {
+		SortDrawList();
+	}
+	Pool<DrawComponent>& draws = Components<DrawComponent>().pool;
+	for (uint32_t i : mDrawList) {
+		draws.At(i)->Render();
 	}
 
+	if (IsHeadless())
+	{
+		// the software renderer rasterizes on flush, which keeps that work inside the OUTPUT phase
+		SDL_FlushRenderer(mSdlRenderer);
+		if (mHeadless.frames > 0)
+		{
+			CaptureFrame();
+		}
+		return;
+	}
+	NN_TRACE_SCOPE("SDL_RenderPresent");
 	SDL_RenderPresent(mSdlRenderer);
 }
 
-void Game::LoadData()
+void Game::StepBench()
+{
+	if (!mBench.Record(mProfiler.Last()))
+	{
+		return;
+	}
+	// every case starts from a fresh actor, so cold caches land in its own warmup frames
+	DestroyActor(mNN);
+	mNN = nullptr;
+	if (!mBench.Done())
+	{
+		LoadNetwork();
+		return;
+	}
+	const double seconds = static_cast<double>(SDL_GetPerformanceCounter() - mHeadlessStart) /
+	                       static_cast<double>(SDL_GetPerformanceFrequency());
+	SDL_Log("benchmark finished in %.2f s", seconds);
+	mBench.WriteJson(static_cast<int>(WINDOW_WIDTH), static_cast<int>(WINDOW_HEIGHT));
+	mContinueRunning = false;
+}
+
+void Game::LoadNetwork()
 {
 	mNN = CreateActor<NeuralNetworkActor>();
-	mNN->GetNN().FromConfig(NN_CFG_PATH);
+	if (mBench.Enabled())
+	{
+		std::istringstream config(mBench.Config());
+		mNN->GetNN().FromStream(config);
+	}
+	else
+	{
+		mNN->GetNN().FromConfig(NN_CFG_PATH);
+	}
 	mNN->SetWidth(927.0f);
 	mNN->SetHeight(549.0f);
 	mNN->GetTransform().SetPosition({HALF_WIDTH, HALF_HEIGHT});
+	// the camera looks at the network through the whole plot area
+	mNN->SetViewport({0.0f, 0.0f, PLOT_WIDTH, WINDOW_HEIGHT});
 	mNN->StartGraphicForward();
+	if (mHeadless.train)
+	{
+		mNN->SetTraining(true);
+	}
+}
+
+void Game::LoadData()
+{
+	LoadNetwork();
+
+	// wall-clock numbers would make headless frames differ run to run
+	if (!IsHeadless())
+	{
+		mHud = CreateActor<PerfHud>();
+		mHud->SetNetwork(mNN);
+	}
 }
 
 void Game::UnloadData()
 {
-	// delete objects and clear vector
-	for (auto& actor : mActors)
+	// destroy every actor (and with them their components); the pools keep their memory
+	for (auto& system : mActorSystems)
 	{
-		delete actor;
+		system->Clear();
 	}
-	mActors.clear();
+	mNN = nullptr;
+	mHud = nullptr;
 }
 
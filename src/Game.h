@@ -8,16 +8,37 @@
 #pragma once
 
 #include "SDL3/SDL.h"
+#include "CircleAtlas.h"
+#include "FrameWriter.h"
+#include "GlyphAtlas.h"
 #include "Math.h"
+#include "Perf.h"
+#include "PipelineBench.h"
+#include "RenderBench.h"
+#include "ThreadPool.h"
 #include <functional>
+#include <memory>
+#include <string>
 #include <vector>
 #include "Actor.h"
+#include "Pool.h"
 
 class Component;
 class DrawComponent;
 using Math::Vector2;
 class NeuralNetworkActor;
 
+// --headless: no window, a software renderer drawing into a surface, animation stepped by a fixed
+// 1/fps instead of the clock, and every frame handed to a FrameWriter. runs as fast as the CPU allows
+struct HeadlessOptions {
+	uint64_t frames = 0;              // 0 = not headless
+	std::string outDir = "frames";
+	float fps = 60.0f;
+	FrameWriter::Format format = FrameWriter::Format::BMP;
+	size_t writers = 0;               // 0 = one per spare core
+	bool train = false;               // train step by step (T) from the first frame
+};
+
 class Game
 {
 public:
@@ -38,6 +59,15 @@ public:
 	// max deltaTime for update
 	static constexpr float MAX_DELTA_TIME = 0.033f;
 
+	// the simulation advances in steps of exactly this; the clock fills an accumulator that's drained in them
+	static constexpr float FIXED_DT = 1.0f / ESTIMATED_FPS;
+	static constexpr Uint64 FIXED_STEP_NS = SDL_NS_PER_SECOND / ESTIMATED_FPS;
+
+	// everything a frame does, main-thread training included, should fit in this to hold ESTIMATED_FPS
+	static constexpr float FRAME_BUDGET_MS = 1000.0f / ESTIMATED_FPS;
+	// held back from the training budget for what happens outside the measured frame; grows on overruns
+	static constexpr float MIN_BUDGET_MARGIN_MS = 0.5f;
+
 	// constant for full color
 	static constexpr Uint8 MAX_COLOR = 255;
 
@@ -48,10 +78,27 @@ public:
 	// constant for 1000 ms in one s
 	static constexpr float MS_PER_SEC = 1000.0f;
 
+	// where F9 (and shutdown) write the trace, in tracing builds
+	static constexpr const char* TRACE_PATH = "nn_trace.json";
+
+
+
+	// frames read back but not yet on disk, headless
+	static constexpr size_t MAX_QUEUED_FRAMES = 32;
+
 
 
 	Game();
 
+	// Reads the command line (see HeadlessOptions), before Initialize
+	// Returns false, after logging usage, on anything it doesn't understand
+	bool ParseArgs(int argc, char** argv);
+
+	// --pipeline runs instead of the game: no window, just TrainPipelined timings in the log
+	[[nodiscard]] bool IsPipelineBench()const{return mPipeline.Enabled();}
+	// false, after logging why, if the network couldn't be loaded or trained
+	bool RunPipelineBench();
+
 	// Initialize the game
 	// Returns true if successful
 	bool Initialize();
@@ -68,20 +115,47 @@ public:
 
 	template<typename A>
 	A* CreateActor() {
-		// create actor on heap, save pointer to vector
-		A* a = new A();
-		mActors.push_back(a);
-		return a;
+		// constructed in place in A's pool; the game owns it until it's destroyed
+		return Actors<A>().pool.Emplace();
 	}
 	void AddPendingDestroy(class Actor* actor);
 
-	void AddRenderable(Component* comp);
-	void RemoveRenderable(Component* comp);
+	// Actor::CreateComponent's storage: T's pool
+	template<typename T>
+	T* CreateComponent(Actor* owner) {
+		return Components<T>().pool.Emplace(owner);
+	}
+	void DestroyComponent(Component* comp);
+
+	// a handle to an actor outlives it safely: once the actor is destroyed it resolves to nullptr
+	template<typename A>
+	[[nodiscard]] Handle<A> GetHandle(const A* actor) {return Actors<A>().pool.HandleOf(actor);}
+	template<typename A>
+	[[nodiscard]] A* Resolve(Handle<A> handle) {return Actors<A>().pool.Get(handle);}
+
+	// a DrawComponent came, went or changed its draw order; the draw list is re-sorted before the next frame
+	void MarkDrawOrderDirty() {mDrawOrderDirty = true;}
 
 	[[nodiscard]] const Vector2& GetMousePos()const{return mMousePos;}
+	// wheel notches (up is positive) since the last input pass; only meaningful during HandleInput
+	[[nodiscard]] float GetMouseWheel()const{return mMouseWheel;}
 
 	SDL_Renderer* GetRenderer(){return mSdlRenderer;}
+	// pre-rasterized neuron sprites, shared by every DrawComponent
+	[[nodiscard]] const CircleAtlas& GetCircleAtlas() const {return mCircleAtlas;}
+	// debug font as a texture, plus the interned label table; shared by every DrawComponent
+	[[nodiscard]] GlyphAtlas& GetGlyphAtlas() {return mGlyphAtlas;}
+	// per-phase timings and counters of recent frames, for the sidebar HUD
+	[[nodiscard]] const Perf::FrameProfiler& GetProfiler() const {return mProfiler;}
+	// workers for per-frame fork/join loops on the main thread
+	[[nodiscard]] ThreadPool& GetThreadPool() {return mThreadPool;}
+	// bumped whenever the renderer loses its render-target contents; offscreen caches compare against it
+	[[nodiscard]] uint64_t GetRenderTargetEpoch() const {return mRenderTargetEpoch;}
 	[[nodiscard]] float GetDT()const{return mDT;}
+	// how far past the last fixed step the frame being drawn is, in [0, 1) steps; animations extrapolate by it
+	[[nodiscard]] float GetAlpha()const{return mAlpha;}
+	// no window: recording frames (--headless) or benchmarking (--bench)
+	[[nodiscard]] bool IsHeadless()const{return mHeadless.frames > 0 || mBench.Enabled();}
 
 	static void LeadingEdge(bool keyBool, bool& lastBool, const std::function<void()>& fn,
 							bool condition = true);
@@ -90,38 +164,166 @@ private:
 	SDL_Window* mSdlWindow;
 	SDL_Renderer* mSdlRenderer;
 
+	// circle sprites sized for the current output, rebuilt when it changes
+	CircleAtlas mCircleAtlas;
+	void RebuildCircleAtlas();
+	uint64_t mRenderTargetEpoch = 0;
+	GlyphAtlas mGlyphAtlas;
+	void RebuildGlyphAtlas();
+	ThreadPool mThreadPool;
+	bool mLastF8 = false;
+	bool mLastF9 = false;
+	bool mLastF10 = false;
+	void DumpTrace();
+	Perf::FrameProfiler mProfiler;
+
+	// headless output: the surface the software renderer draws into, and where its frames go
+	HeadlessOptions mHeadless;
+	SDL_Surface* mOffscreen = nullptr;
+	FrameWriter mFrameWriter;
+	uint64_t mFramesRendered = 0;
+	Uint64 mHeadlessStart = 0;
+	bool InitializeHeadless();
+	void CaptureFrame();
+	// --bench: swaps in the next synthesized network whenever a case finishes
+	RenderBench mBench;
+	void StepBench();
+	PipelineBench mPipeline;
+
 	// keep the game going
 	bool mContinueRunning;
 	bool mGameDone = false;
 
 
-	// actors vector and individual member variables
-	std::vector<Actor*> mActors;
-	std::vector<Actor*> mPendingCreate;
+	// one system per component and actor type: the type's pool, and the loops over it. a frame costs one
+	// virtual call per type and phase; inside, objects are visited in slot order through their concrete type
+	struct ComponentSystem {
+		virtual ~ComponentSystem() = default;
+		virtual void Update(float deltaTime) = 0;
+		virtual void Input(const bool keys[], SDL_MouseButtonFlags buttons, const Vector2& mouse) = 0;
+		// false if comp isn't one of this pool's
+		virtual bool Destroy(Component* comp) = 0;
+	};
+	template<typename T>
+	struct ComponentPool final : ComponentSystem {
+		Pool<T> pool;
+		void Update(float deltaTime) override {pool.ForEach([deltaTime](T& c) {c.Update(deltaTime);});}
+		void Input(const bool keys[], SDL_MouseButtonFlags buttons, const Vector2& mouse) override {
+			pool.ForEach([&](T& c) {c.Input(keys, buttons, mouse);});
+		}
+		bool Destroy(Component* comp) override {
+			// slots hold the most-derived object, so look up its address rather than the base's
+			if (pool.IndexOf(dynamic_cast<void*>(comp)) == Handle<T>::INVALID) return false;
+			pool.Erase(static_cast<T*>(comp));
+			return true;
+		}
+	};
+	struct ActorSystem {
+		virtual ~ActorSystem() = default;
+		virtual void Update(float deltaTime) = 0;
+		virtual void Render() = 0;
+		virtual void Input(const bool keys[], SDL_MouseButtonFlags buttons, const Vector2& mouse) = 0;
+		[[nodiscard]] virtual bool AnyDirty() const = 0;
+		virtual void ClearDirty() = 0;
+		// false if actor isn't one of this pool's
+		virtual bool Destroy(Actor* actor) = 0;
+		virtual void Clear() = 0;
+	};
+	template<typename A>
+	struct ActorPool final : ActorSystem {
+		Pool<A> pool;
+		void Update(float deltaTime) override {pool.ForEach([deltaTime](A& a) {a.Update(deltaTime);});}
+		void Render() override {pool.ForEach([](A& a) {a.Render();});}
+		void Input(const bool keys[], SDL_MouseButtonFlags buttons, const Vector2& mouse) override {
+			pool.ForEach([&](A& a) {a.Input(keys, buttons, mouse);});
+		}
+		[[nodiscard]] bool AnyDirty() const override {
+			bool dirty = false;
+			pool.ForEach([&dirty](A& a) {dirty = dirty || a.IsDirty();});
+			return dirty;
+		}
+		void ClearDirty() override {pool.ForEach([](A& a) {a.ClearDirty();});}
+		bool Destroy(Actor* actor) override {
+			if (pool.IndexOf(dynamic_cast<void*>(actor)) == Handle<A>::INVALID) return false;
+			pool.Erase(static_cast<A*>(actor));
+			return true;
+		}
+		void Clear() override {pool.Clear();}
+	};
+
+	// systems in the order their types were first used, and by PoolTypeId for lookup.
+	// components are declared first so they outlive the actors that own them
+	std::vector<std::unique_ptr<ComponentSystem>> mComponentSystems;
+	std::vector<ComponentSystem*> mComponentSystemById;
+	std::vector<std::unique_ptr<ActorSystem>> mActorSystems;
+	std::vector<ActorSystem*> mActorSystemById;
+	template<typename T>
+	ComponentPool<T>& Components() {
+		return Registered<ComponentPool<T>>(PoolTypeId<T>(), mComponentSystems, mComponentSystemById);
+	}
+	template<typename A>
+	ActorPool<A>& Actors() {
+		return Registered<ActorPool<A>>(PoolTypeId<A>(), mActorSystems, mActorSystemById);
+	}
+	template<typename S, typename Base>
+	static S& Registered(uint32_t id, std::vector<std::unique_ptr<Base>>& systems, std::vector<Base*>& byId) {
+		if (id >= byId.size()) byId.resize(id + 1, nullptr);
+		if (byId[id] == nullptr) {
+			systems.push_back(std::make_unique<S>());
+			byId[id] = systems.back().get();
+		}
+		return static_cast<S&>(*byId[id]);
+	}
+
+	// DrawComponent slots in draw order (ties keep slot order), re-sorted only when marked dirty
+	std::vector<uint32_t> mDrawList;
+	bool mDrawOrderDirty = false;
+	void SortDrawList();
+
 	std::vector<Actor*> mPendingDestroy;
-	std::vector<Component*> mRenderables;
 	NeuralNetworkActor* mNN = nullptr;
+	class PerfHud* mHud = nullptr;
 
 	void DestroyActor(Actor* actor);
 
 
-	// prev time for delta calcs
+	// prev time for delta calcs, in ns
 	Uint64 mPreviousTime;
 
 	void ProcessInput();
 	void UpdateGame();
 	void GenerateOutput();
+	// one fixed step of every actor
+	void StepSimulation(float deltaTime);
+	// main-thread training in what's left of FRAME_BUDGET_MS (F)
+	void TrainInBudget();
+
+	// idle skipping (F8): a frame is only drawn when an actor is dirty or an event arrived since the last one
+	bool mIdleSkip = true;
+	bool mWake = true;
+	[[nodiscard]] bool NeedsRedraw() const;
 
 	void LoadData();
+	// the network actor, from nn.cfg or the current benchmark case
+	void LoadNetwork();
 	void UnloadData();
 
 
 
 	float mDT = 0.0f;
+	Uint64 mAccumulatorNs = 0;
+	float mAlpha = 0.0f;
+	float mBudgetMarginMs = MIN_BUDGET_MARGIN_MS;
 	Vector2 mMousePos;
+	float mMouseWheel = 0.0f;
 
 };
 
 extern Game gGame;
 
+template <typename T>
+T* NewComponent(Actor* owner) {
+	return gGame.CreateComponent<T>(owner);
+}
+
 #endif //RELATIVITY_GAME_H
\ No newline at end of file
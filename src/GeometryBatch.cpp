@@ -0,0 +1,99 @@
+//
+// Created by Ben Meyers on 3/12/26.
+//
+
+#include "GeometryBatch.h"
+#include <algorithm>
+#include "Math.h"
+#include "Perf.h"
+#include "Trace.h"
+
+void GeometryBatch::AddLine(float x1, float y1, float x2, float y2, float thickness, const SDL_FColor& color) {
+    // ditch empty lines
+    const float dx = x2 - x1;
+    const float dy = y2 - y1;
+    const float len = Math::Sqrt(dx*dx + dy*dy);
+    if (len < 1.0f) return;
+
+    // if the line's direction vector is [dx, dy], then the perpendicular is [-dy, dx];
+    // scale it to half the thickness and push the two long edges out either side
+    const float half = std::max(thickness, 1.0f) * 0.5f;
+    const float px = -dy / len * half;
+    const float py =  dx / len * half;
+
+    const int base = static_cast<int>(mVertices.size());
+    mVertices.push_back({{x1 + px, y1 + py}, color, {0.0f, 0.0f}});
+    mVertices.push_back({{x2 + px, y2 + py}, color, {0.0f, 0.0f}});
+    mVertices.push_back({{x2 - px, y2 - py}, color, {0.0f, 0.0f}});
+    mVertices.push_back({{x1 - px, y1 - py}, color, {0.0f, 0.0f}});
+    mIndices.insert(mIndices.end(), {base, base + 1, base + 2, base, base + 2, base + 3});
+}
+
+void GeometryBatch::AddQuad(const SDL_FRect& dst, const SDL_FRect& uv, const SDL_FColor& color) {
+    const int base = static_cast<int>(mVertices.size());
+    mVertices.push_back({{dst.x,         dst.y},         color, {uv.x,        uv.y}});
+    mVertices.push_back({{dst.x + dst.w, dst.y},         color, {uv.x + uv.w, uv.y}});
+    mVertices.push_back({{dst.x + dst.w, dst.y + dst.h}, color, {uv.x + uv.w, uv.y + uv.h}});
+    mVertices.push_back({{dst.x,         dst.y + dst.h}, color, {uv.x,        uv.y + uv.h}});
+    mIndices.insert(mIndices.end(), {base, base + 1, base + 2, base, base + 2, base + 3});
+}
+
+void GeometryBatch::AddRect(const SDL_FRect& rect, const SDL_FColor& color) {
+    AddQuad(rect, {0.0f, 0.0f, 0.0f, 0.0f}, color);
+}
+
+void GeometryBatch::AddOutlineRect(const SDL_FRect& rect, const SDL_FColor& color) {
+    if (rect.w <= 0.0f || rect.h <= 0.0f) return;
+    // 2px or less across, the 1px sides would overlap (or the left/right ones turn inside out): it's all border
+    if (rect.w <= 2.0f || rect.h <= 2.0f) {
+        AddRect(rect, color);
+        return;
+    }
+    // top, bottom, left, right (sides skip the corners so they aren't blended twice)
+    AddRect({rect.x, rect.y, rect.w, 1.0f}, color);
+    AddRect({rect.x, rect.y + rect.h - 1.0f, rect.w, 1.0f}, color);
+    AddRect({rect.x, rect.y + 1.0f, 1.0f, rect.h - 2.0f}, color);
+    AddRect({rect.x + rect.w - 1.0f, rect.y + 1.0f, 1.0f, rect.h - 2.0f}, color);
+}
+
+void GeometryBatch::AddCircle(float cx, float cy, float radius, const SDL_FColor& color) {
+    if (radius <= 0.0f) return;
+    // about one segment per 3px of circumference, enough that the polygon edge is invisible
+    const int segments = Math::Clamp(static_cast<int>(2.0f * Math::Pi * radius / 3.0f), 8, 64);
+    const float step = 2.0f * Math::Pi / static_cast<float>(segments);
+
+    const int center = static_cast<int>(mVertices.size());
+    mVertices.push_back({{cx, cy}, color, {0.0f, 0.0f}});
+    // walk the ring by rotating a unit vector, so it's one cos/sin per circle instead of per vertex
+    const float cosStep = Math::Cos(step), sinStep = Math::Sin(step);
+    float ux = 1.0f, uy = 0.0f;
+    for (int i = 0; i < segments; ++i) {
+        mVertices.push_back({{cx + radius * ux, cy + radius * uy}, color, {0.0f, 0.0f}});
+        const float nx = ux * cosStep - uy * sinStep;
+        uy = ux * sinStep + uy * cosStep;
+        ux = nx;
+    }
+    // fan: (center, i, i+1), wrapping the last one back to the first ring vertex
+    for (int i = 0; i < segments; ++i) {
+        const int next = (i + 1) % segments;
+        mIndices.insert(mIndices.end(), {center, center + 1 + i, center + 1 + next});
+    }
+}
+
+void GeometryBatch::SetColor(size_t firstVertex, size_t count, const SDL_FColor& color) {
+    for (size_t i = firstVertex; i < firstVertex + count; ++i) mVertices[i].color = color;
+}
+
+void GeometryBatch::Submit(SDL_Renderer* renderer, SDL_Texture* texture) const {
+    if (mIndices.empty()) return;
+    NN_TRACE_SCOPE("SDL_RenderGeometry");
+    Perf::CountDraw(mVertices.size());
+    SDL_RenderGeometry(renderer, texture,
+                       mVertices.data(), static_cast<int>(mVertices.size()),
+                       mIndices.data(), static_cast<int>(mIndices.size()));
+}
+
+void GeometryBatch::Clear() {
+    mVertices.clear();
+    mIndices.clear();
+}
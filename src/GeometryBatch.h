@@ -0,0 +1,46 @@
+//
+// Created by Ben Meyers on 3/12/26.
+//
+
+#ifndef NEURAL_NETWORK_CIRCUIT_VISUALIZATION_GEOMETRYBATCH_H
+#define NEURAL_NETWORK_CIRCUIT_VISUALIZATION_GEOMETRYBATCH_H
+
+#include <vector>
+#include "SDL3/SDL_render.h"
+
+// A CPU-side triangle list that goes to the GPU in a single SDL_RenderGeometry call.
+// Shapes are tessellated into it with per-vertex color; Clear() keeps capacity between frames.
+class GeometryBatch {
+    std::vector<SDL_Vertex> mVertices;
+    std::vector<int>        mIndices;
+
+public:
+    // 8-bit color -> the float color SDL_Vertex wants
+    static SDL_FColor ToFColor(Uint8 r, Uint8 g, Uint8 b, Uint8 a) {
+        constexpr float inv = 1.0f / 255.0f;
+        return {r * inv, g * inv, b * inv, a * inv};
+    }
+
+    // thick line as a quad centered on the segment
+    void AddLine(float x1, float y1, float x2, float y2, float thickness, const SDL_FColor& color);
+    void AddRect(const SDL_FRect& rect, const SDL_FColor& color);
+    // 1px border made of four thin quads (one filled quad when the rect is 2px or less across)
+    void AddOutlineRect(const SDL_FRect& rect, const SDL_FColor& color);
+    // triangle fan around the center; segment count grows with radius
+    void AddCircle(float cx, float cy, float radius, const SDL_FColor& color);
+    // textured quad (uv in 0..1 of whatever texture the batch is submitted with)
+    void AddQuad(const SDL_FRect& dst, const SDL_FRect& uv, const SDL_FColor& color);
+
+    // recolor vertices already in the batch (for batches kept across frames whose positions don't change)
+    void SetColor(size_t firstVertex, size_t count, const SDL_FColor& color);
+
+    // one draw call for everything in the batch (uses the renderer's draw blend mode when untextured)
+    void Submit(SDL_Renderer* renderer, SDL_Texture* texture = nullptr) const;
+    void Clear();
+
+    [[nodiscard]] bool Empty() const { return mIndices.empty(); }
+    [[nodiscard]] size_t VertexCount() const { return mVertices.size(); }
+    [[nodiscard]] size_t IndexCount() const { return mIndices.size(); }
+};
+
+#endif //NEURAL_NETWORK_CIRCUIT_VISUALIZATION_GEOMETRYBATCH_H
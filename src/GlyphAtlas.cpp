@@ -0,0 +1,70 @@
+//
+// Created by Ben Meyers on 3/20/26.
+//
+
+#include "GlyphAtlas.h"
+
+GlyphAtlas::~GlyphAtlas() {
+    Destroy();
+}
+
+void GlyphAtlas::Destroy() {
+    if (mTexture) SDL_DestroyTexture(mTexture);
+    mTexture = nullptr;
+}
+
+bool GlyphAtlas::Build(SDL_Renderer* renderer) {
+    Destroy();
+    constexpr int glyphs = LAST_CHAR - FIRST_CHAR + 1;
+    mAtlasW = ATLAS_COLS * CELL_PIXELS;
+    mAtlasH = (glyphs + ATLAS_COLS - 1) / ATLAS_COLS * CELL_PIXELS;
+    mTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET, mAtlasW, mAtlasH);
+    if (!mTexture) return false;
+    SDL_SetTextureBlendMode(mTexture, SDL_BLENDMODE_BLEND);
+    // it's a pixel font: keep it blocky, like SDL_RenderDebugText
+    SDL_SetTextureScaleMode(mTexture, SDL_SCALEMODE_NEAREST);
+
+    // draw every glyph once, in white, into its cell; leave the renderer as we found it
+    SDL_Texture* previous = SDL_GetRenderTarget(renderer);
+    Uint8 r, g, b, a;
+    SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+    SDL_SetRenderTarget(renderer, mTexture);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderClear(renderer);
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+    char glyph[2] = {0, 0};
+    for (int i = 0; i < glyphs; ++i) {
+        glyph[0] = static_cast<char>(FIRST_CHAR + i);
+        const auto x = static_cast<float>(i % ATLAS_COLS * CELL_PIXELS + 1);
+        const auto y = static_cast<float>(i / ATLAS_COLS * CELL_PIXELS + 1);
+        SDL_RenderDebugText(renderer, x, y, glyph);
+    }
+    SDL_SetRenderTarget(renderer, previous);
+    SDL_SetRenderDrawColor(renderer, r, g, b, a);
+    return true;
+}
+
+GlyphAtlas::Label GlyphAtlas::Intern(std::string_view text) {
+    if (const auto it = mIds.find(text); it != mIds.end()) return it->second;
+    const auto id = static_cast<Label>(mStrings.size());
+    mStrings.emplace_back(text);
+    mIds.emplace(mStrings.back(), id);
+    return id;
+}
+
+void GlyphAtlas::Layout(GeometryBatch& batch, float x, float y, std::string_view text, float scale, const SDL_FColor& color) const {
+    const float size = static_cast<float>(GLYPH_PIXELS) * scale;
+    const float invW = 1.0f / static_cast<float>(mAtlasW);
+    const float invH = 1.0f / static_cast<float>(mAtlasH);
+    for (char ch : text) {
+        if (ch != ' ') {
+            if (ch < FIRST_CHAR || ch > LAST_CHAR) ch = '?';
+            const int i = ch - FIRST_CHAR;
+            const SDL_FRect uv = {static_cast<float>(i % ATLAS_COLS * CELL_PIXELS + 1) * invW,
+                                  static_cast<float>(i / ATLAS_COLS * CELL_PIXELS + 1) * invH,
+                                  static_cast<float>(GLYPH_PIXELS) * invW, static_cast<float>(GLYPH_PIXELS) * invH};
+            batch.AddQuad({x, y, size, size}, uv, color);
+        }
+        x += size;
+    }
+}
@@ -0,0 +1,60 @@
+//
+// Created by Ben Meyers on 3/20/26.
+//
+
+#ifndef NEURAL_NETWORK_CIRCUIT_VISUALIZATION_GLYPHATLAS_H
+#define NEURAL_NETWORK_CIRCUIT_VISUALIZATION_GLYPHATLAS_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "GeometryBatch.h"
+#include "SDL3/SDL_render.h"
+
+// SDL's 8x8 debug font baked once into a texture, so text becomes textured quads in a GeometryBatch
+// (any number of labels, any mix of scales, one draw call) instead of one SDL_RenderDebugText per label
+// bracketed by render-scale changes. Repeated strings can be interned and referred to by a small id.
+class GlyphAtlas {
+public:
+    using Label = uint32_t;
+    static constexpr Label NO_LABEL = UINT32_MAX;
+
+    static constexpr int GLYPH_PIXELS = 8;
+    // printable ASCII; anything else is drawn as '?'
+    static constexpr char FIRST_CHAR = ' ';
+    static constexpr char LAST_CHAR  = '~';
+
+    GlyphAtlas() = default;
+    ~GlyphAtlas();
+    GlyphAtlas(const GlyphAtlas&) = delete;
+    GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+
+    // renders every glyph into a target texture. called at startup and whenever the renderer loses its targets
+    bool Build(SDL_Renderer* renderer);
+    void Destroy();
+    [[nodiscard]] SDL_Texture* GetTexture() const { return mTexture; }
+
+    // same id for the same text, for as long as the atlas lives. meant for a small set of recurring labels,
+    // not for text that changes every frame (that would grow the table forever)
+    Label Intern(std::string_view text);
+    [[nodiscard]] std::string_view Text(Label label) const { return mStrings[label]; }
+
+    // append one quad per visible character, top-left at (x, y), GLYPH_PIXELS * scale per cell
+    void Layout(GeometryBatch& batch, float x, float y, std::string_view text, float scale, const SDL_FColor& color) const;
+
+private:
+    // 1px transparent border around each glyph so scaled quads don't sample their neighbours
+    static constexpr int CELL_PIXELS = GLYPH_PIXELS + 2;
+    static constexpr int ATLAS_COLS  = 16;
+
+    SDL_Texture* mTexture = nullptr;
+    int mAtlasW = 0, mAtlasH = 0;
+
+    // deque so the strings (and the views the map keys on) never move
+    std::deque<std::string> mStrings;
+    std::unordered_map<std::string_view, Label> mIds;
+};
+
+#endif //NEURAL_NETWORK_CIRCUIT_VISUALIZATION_GLYPHATLAS_H
@@ -0,0 +1,60 @@
+//
+// Created by Ben Meyers on 3/2/26.
+//
+
+#include "HalfMatrix.h"
+#include <stdexcept>
+#include <string>
+
+HalfMatrix::HalfMatrix(const DynamicMatrix& src, const WeightPrecision precision)
+    : mPrecision(precision) {
+    if (precision == WeightPrecision::FP32)
+        throw std::runtime_error("HalfMatrix: precision must be bf16 or fp16");
+    Quantize(src);
+}
+
+void HalfMatrix::Quantize(const DynamicMatrix& src) {
+    mRows = src.Rows();
+    mCols = src.Cols();
+    mData.resize(mRows * mCols);
+    // pick the converter once, not per element
+    const auto toHalf = mPrecision == WeightPrecision::BF16 ? Half::ToBF16 : Half::ToFP16;
+    for (size_t r = 0; r < mRows; r++)
+        for (size_t c = 0; c < mCols; c++)
+            mData[r * mCols + c] = toHalf(src.at(r, c));
+}
+
+float HalfMatrix::at(const size_t r, const size_t c) const {
+    const uint16_t h = mData[r * mCols + c];
+    return mPrecision == WeightPrecision::BF16 ? Half::FromBF16(h) : Half::FromFP16(h);
+}
+
+// the actual kernel, specialized per format so the inner loop has no branch
+template<float (*ToFloat)(uint16_t)>
+static void HalfGemm(const std::vector<uint16_t>& a, size_t rows, size_t inner,
+                     const DynamicMatrix& b, DynamicMatrix& out) {
+    const size_t cols = b.Cols();
+    for (size_t i = 0; i < rows; i++) {
+        const uint16_t* aRow = a.data() + i * inner;
+        for (size_t k = 0; k < inner; k++) {
+            // widen each weight exactly once, then accumulate in fp32
+            const float w = ToFloat(aRow[k]);
+            for (size_t j = 0; j < cols; j++)
+                out.at(i, j) += w * b.at(k, j);
+        }
+    }
+}
+
+DynamicMatrix HalfMatrix::operator*(const DynamicMatrix& other) const {
+    if (mCols != other.Rows())
+        throw std::runtime_error("Half matrix multiply: incompatible shapes (" +
+            std::to_string(mRows) + "x" + std::to_string(mCols) + ") * (" +
+            std::to_string(other.Rows()) + "x" + std::to_string(other.Cols()) + ")");
+
+    DynamicMatrix result(mRows, other.Cols());
+    if (mPrecision == WeightPrecision::BF16)
+        HalfGemm<Half::FromBF16>(mData, mRows, mCols, other, result);
+    else
+        HalfGemm<Half::FromFP16>(mData, mRows, mCols, other, result);
+    return result;
+}
@@ -0,0 +1,109 @@
+//
+// Created by Ben Meyers on 3/2/26.
+//
+
+#ifndef NEURAL_NETWORK_CIRCUIT_VISUALIZATION_HALFMATRIX_H
+#define NEURAL_NETWORK_CIRCUIT_VISUALIZATION_HALFMATRIX_H
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+#include "DynamicMatrix.h"
+
+// storage format for a layer's forward-pass weights
+// FP32 = use the master weights directly, BF16/FP16 = half-width copy
+enum class WeightPrecision {FP32, BF16, FP16};
+
+inline std::string_view PrecisionName(const WeightPrecision& p) {
+    switch (p) {
+        case WeightPrecision::FP32: return "fp32";
+        case WeightPrecision::BF16: return "bf16";
+        case WeightPrecision::FP16: return "fp16";
+    }
+    return "?";
+}
+
+namespace Half {
+    inline uint32_t Bits(float f)     { uint32_t u; std::memcpy(&u, &f, sizeof(u)); return u; }
+    inline float    FromBits(uint32_t u) { float f; std::memcpy(&f, &u, sizeof(f)); return f; }
+
+    // bf16 is just the top half of an fp32, rounded to nearest even
+    inline uint16_t ToBF16(float f) {
+        uint32_t u = Bits(f);
+        // keep NaNs NaN (rounding could carry them into inf)
+        if ((u & 0x7fffffffu) > 0x7f800000u) return static_cast<uint16_t>((u >> 16) | 0x0040u);
+        u += 0x7fffu + ((u >> 16) & 1u);
+        return static_cast<uint16_t>(u >> 16);
+    }
+    inline float FromBF16(uint16_t h) { return FromBits(static_cast<uint32_t>(h) << 16); }
+
+    // IEEE binary16: 1 sign, 5 exponent, 10 mantissa bits, round to nearest even
+    inline uint16_t ToFP16(float f) {
+        const uint32_t u    = Bits(f);
+        const auto     sign = static_cast<uint16_t>((u >> 16) & 0x8000u);
+        const uint32_t absU = u & 0x7fffffffu;
+
+        // inf / NaN
+        if (absU >= 0x7f800000u)
+            return sign | (absU > 0x7f800000u ? 0x7e00u : 0x7c00u);
+        // too big for half -> inf
+        if (absU >= 0x477ff000u)
+            return sign | 0x7c00u;
+        // normal half range
+        if (absU >= 0x38800000u) {
+            uint32_t r = absU - 0x38000000u;  // rebias exponent 127 -> 15
+            r += 0x0fffu + ((r >> 13) & 1u);
+            return sign | static_cast<uint16_t>(r >> 13);
+        }
+        // subnormal half (or rounds to zero)
+        if (absU < 0x33000000u) return sign;
+        const uint32_t exp   = absU >> 23;
+        const uint32_t mant  = (absU & 0x007fffffu) | 0x00800000u;
+        const uint32_t shift = 126u - exp;  // half subnormals are multiples of 2^-24
+        uint32_t r = mant >> shift;
+        const uint32_t rem  = mant & ((1u << shift) - 1u);
+        const uint32_t half = 1u << (shift - 1u);
+        if (rem > half || (rem == half && (r & 1u))) r++;
+        return sign | static_cast<uint16_t>(r);
+    }
+    inline float FromFP16(uint16_t h) {
+        const uint32_t sign = (static_cast<uint32_t>(h) & 0x8000u) << 16;
+        const uint32_t exp  = (h >> 10) & 0x1fu;
+        uint32_t       mant = h & 0x03ffu;
+        if (exp == 0x1fu) return FromBits(sign | 0x7f800000u | (mant << 13));
+        if (exp != 0)     return FromBits(sign | ((exp + 112u) << 23) | (mant << 13));
+        if (mant == 0)    return FromBits(sign);
+        // subnormal: normalize the mantissa
+        int e = -1;
+        do { mant <<= 1; e++; } while (!(mant & 0x0400u));
+        return FromBits(sign | ((112u - e) << 23) | ((mant & 0x03ffu) << 13));
+    }
+}
+
+// Half-width (16-bit) copy of a DynamicMatrix. Values are converted back to fp32
+// on the fly inside the multiply, and all accumulation happens in fp32.
+class HalfMatrix {
+    std::vector<uint16_t> mData;
+    size_t mRows = 0, mCols = 0;
+    WeightPrecision mPrecision = WeightPrecision::BF16;
+
+public:
+    HalfMatrix() = default;
+    HalfMatrix(const DynamicMatrix& src, WeightPrecision precision);
+
+    // re-round from the fp32 master copy (reuses storage when shape is unchanged)
+    void Quantize(const DynamicMatrix& src);
+
+    [[nodiscard]] float at(size_t r, size_t c) const;
+
+    [[nodiscard]] size_t Rows() const { return mRows; }
+    [[nodiscard]] size_t Cols() const { return mCols; }
+    [[nodiscard]] bool Empty() const { return mData.empty(); }
+    [[nodiscard]] WeightPrecision Precision() const { return mPrecision; }
+
+    // matmul against fp32 activations: half weights in, fp32 out
+    DynamicMatrix operator*(const DynamicMatrix& other) const;
+};
+
+#endif //NEURAL_NETWORK_CIRCUIT_VISUALIZATION_HALFMATRIX_H
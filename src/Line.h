@@ -9,7 +9,7 @@
 #include "Game.h"
 class DrawComponent;
 
-class Line : public  Actor{
+class Line final : public  Actor{
     Vector2 mSlope;
     Vector2 mOrigin;
     DrawComponent* mDraw = nullptr;
@@ -0,0 +1,72 @@
+//
+// Created by Ben Meyers on 3/19/26.
+//
+
+#include "NetworkLayout.h"
+#include <algorithm>
+#include <cmath>
+
+bool NetworkLayout::Update(float originX, float originY, float width, float height, const std::vector<Layer>& layers) {
+    // +1 for input column (which is not actually a Layer, but which we do render)
+    const size_t totalCols = layers.size() + 1;
+    bool same = originX == mOriginX && originY == mOriginY && width == mWidth && height == mHeight
+                && mCounts.size() == totalCols && !layers.empty();
+    for (size_t c = 0; same && c < totalCols; ++c)
+        same = mCounts[c] == static_cast<int>(c == 0 ? layers[0].InSize() : layers[c - 1].OutSize());
+    if (same) return false;
+
+    mOriginX = originX;
+    mOriginY = originY;
+    mWidth = width;
+    mHeight = height;
+    mCounts.assign(totalCols, 0);
+    mColumnStart.assign(totalCols, 0);
+    mCenters.clear();
+    ++mGeneration;
+    if (layers.empty()) return true;
+
+    // neuron counts for each column
+    mCounts[0] = static_cast<int>(layers[0].InSize());
+    for (size_t c = 1; c < totalCols; ++c)
+        mCounts[c] = static_cast<int>(layers[c - 1].OutSize());
+
+    // -1 because we have N columns so N-1 gaps
+    mColStep = width / static_cast<float>(totalCols - 1);
+
+    // radius is determined by the smallest row gap.
+    // total magic number...max for it would be 0.5f because then these two half radii would kiss
+    const int maxNeurons = *std::max_element(mCounts.begin(), mCounts.end());
+    const float minRowStep = height / static_cast<float>(maxNeurons + 1);
+    mRadius = Math::Min(mColStep, minRowStep) * 0.36f;
+
+    for (size_t c = 0; c < totalCols; ++c) {
+        mColumnStart[c] = mCenters.size();
+        for (int n = 0; n < mCounts[c]; ++n)
+            mCenters.push_back(NeuronPos(static_cast<int>(c), n, mCounts[c], mColStep, height, originX, originY));
+    }
+    return true;
+}
+
+namespace {
+    // [ceil(lo), floor(hi)] as a half-open index range clamped to [0, count)
+    void IndexRange(float lo, float hi, int count, int& first, int& last) {
+        const auto n = static_cast<float>(count);
+        first = static_cast<int>(std::ceil(std::clamp(lo, 0.0f, n)));
+        last  = std::max(first, static_cast<int>(std::floor(std::clamp(hi, -1.0f, n - 1.0f))) + 1);
+    }
+}
+
+void NetworkLayout::VisibleColumns(float left, float right, int& first, int& last) const {
+    first = last = 0;
+    if (Columns() < 2 || mColStep <= 0.0f) return;
+    IndexRange((left - mOriginX) / mColStep, (right - mOriginX) / mColStep, Columns(), first, last);
+}
+
+void NetworkLayout::VisibleRows(int col, float top, float bottom, int& first, int& last) const {
+    first = last = 0;
+    const int count = mCounts[col];
+    if (count == 0 || mHeight <= 0.0f) return;
+    // same spacing as NeuronPos: neuron n sits at (n + 1) row steps
+    const float rowStep = mHeight / static_cast<float>(count + 1);
+    IndexRange((top - mOriginY) / rowStep - 1.0f, (bottom - mOriginY) / rowStep - 1.0f, count, first, last);
+}
@@ -0,0 +1,57 @@
+//
+// Created by Ben Meyers on 3/19/26.
+//
+
+#ifndef NEURAL_NETWORK_CIRCUIT_VISUALIZATION_NETWORKLAYOUT_H
+#define NEURAL_NETWORK_CIRCUIT_VISUALIZATION_NETWORKLAYOUT_H
+
+#include <cstdint>
+#include <vector>
+#include "Math.h"
+#include "NeuralNetwork.h"
+
+using Math::Vector2;
+
+// Where every neuron of a network sits inside a box on screen.
+// Recomputed only when the box or the column sizes change; Generation() ticks when it does,
+// so anything built from these positions (vertex arrays, baked textures) can key on it.
+class NetworkLayout {
+public:
+    // cheap when nothing moved (compares a handful of floats and one count per column). true if it rebuilt
+    bool Update(float originX, float originY, float width, float height, const std::vector<Layer>& layers);
+
+    [[nodiscard]] uint64_t Generation() const { return mGeneration; }
+    [[nodiscard]] int Columns() const { return static_cast<int>(mCounts.size()); }
+    [[nodiscard]] int Count(int col) const { return mCounts[col]; }
+    [[nodiscard]] const std::vector<int>& Counts() const { return mCounts; }
+    [[nodiscard]] Vector2 Center(int col, int neuron) const { return mCenters[mColumnStart[col] + neuron]; }
+    [[nodiscard]] float ColStep() const { return mColStep; }
+    [[nodiscard]] float Radius() const { return mRadius; }
+    [[nodiscard]] float OriginX() const { return mOriginX; }
+    [[nodiscard]] float OriginY() const { return mOriginY; }
+    [[nodiscard]] float Width() const { return mWidth; }
+    [[nodiscard]] float Height() const { return mHeight; }
+
+    // the spatial index: columns and each column's rows are evenly spaced, so what lies in a span is arithmetic.
+    // columns [first, last) with x in [left, right], and neurons [first, last) of col with y in [top, bottom].
+    // first == last when nothing does
+    void VisibleColumns(float left, float right, int& first, int& last) const;
+    void VisibleRows(int col, float top, float bottom, int& first, int& last) const;
+
+    // neuron n of count in a column, relative to (originX, originY). +1 because the height
+    // includes half neurons on top/bottom. shared with anything that lays out in its own space (baked textures)
+    static Vector2 NeuronPos(int col, int neuronIdx, int neuronCount, float colStep, float height, float originX, float originY) {
+        float rowStep = height / static_cast<float>(neuronCount + 1);
+        return {originX + static_cast<float>(col) * colStep, originY + static_cast<float>(neuronIdx + 1) * rowStep};
+    }
+
+private:
+    float mOriginX = 0.0f, mOriginY = 0.0f, mWidth = -1.0f, mHeight = -1.0f;
+    float mColStep = 0.0f, mRadius = 0.0f;
+    std::vector<int>     mCounts;       // neurons per column, input column included
+    std::vector<size_t>  mColumnStart;  // index of each column's first center
+    std::vector<Vector2> mCenters;      // every neuron, column by column
+    uint64_t mGeneration = 0;
+};
+
+#endif //NEURAL_NETWORK_CIRCUIT_VISUALIZATION_NETWORKLAYOUT_H
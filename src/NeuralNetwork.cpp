@@ -4,67 +4,221 @@
 
 #include "NeuralNetwork.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <deque>
 #include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <random>
 #include <sstream>
 #include <stdexcept>
+#include "SpscQueue.h"
+#include "Trace.h"
+
+
+// ---- im2col / col2im ----
+// unroll every kernel-sized patch of a [C*H*W x 1] image into one column of a
+// [C*k*k x outH*outW] matrix, so the convolution becomes a single W * cols GEMM
+static DynamicMatrix Im2Col(const DynamicMatrix& image, const ConvShape& s) {
+    const size_t k = s.kernel;
+    DynamicMatrix cols(s.inChannels * k * k, s.outH * s.outW);
+    for (size_t ch = 0; ch < s.inChannels; ch++)
+        for (size_t ky = 0; ky < k; ky++)
+            for (size_t kx = 0; kx < k; kx++) {
+                const size_t row = (ch * k + ky) * k + kx;
+                for (size_t oy = 0; oy < s.outH; oy++) {
+                    // signed so padding can reach "before" the image
+                    const auto iy = static_cast<long>(oy * s.stride + ky) - static_cast<long>(s.pad);
+                    if (iy < 0 || iy >= static_cast<long>(s.inH)) continue;
+                    for (size_t ox = 0; ox < s.outW; ox++) {
+                        const auto ix = static_cast<long>(ox * s.stride + kx) - static_cast<long>(s.pad);
+                        if (ix < 0 || ix >= static_cast<long>(s.inW)) continue;
+                        cols.at(row, oy * s.outW + ox) = image.at((ch * s.inH + iy) * s.inW + ix, 0);
+                    }
+                }
+            }
+    return cols;
+}
 
+// inverse scatter of Im2Col: overlapping patches add up, padding is dropped
+static DynamicMatrix Col2Im(const DynamicMatrix& cols, const ConvShape& s) {
+    const size_t k = s.kernel;
+    DynamicMatrix image(s.inChannels * s.inH * s.inW, 1);
+    for (size_t ch = 0; ch < s.inChannels; ch++)
+        for (size_t ky = 0; ky < k; ky++)
+            for (size_t kx = 0; kx < k; kx++) {
+                const size_t row = (ch * k + ky) * k + kx;
+                for (size_t oy = 0; oy < s.outH; oy++) {
+                    const auto iy = static_cast<long>(oy * s.stride + ky) - static_cast<long>(s.pad);
+                    if (iy < 0 || iy >= static_cast<long>(s.inH)) continue;
+                    for (size_t ox = 0; ox < s.outW; ox++) {
+                        const auto ix = static_cast<long>(ox * s.stride + kx) - static_cast<long>(s.pad);
+                        if (ix < 0 || ix >= static_cast<long>(s.inW)) continue;
+                        image.at((ch * s.inH + iy) * s.inW + ix, 0) += cols.at(row, oy * s.outW + ox);
+                    }
+                }
+            }
+    return image;
+}
 
-// simple implementations
-static float sigmoid(float x) { return 1.0f / (1.0f + std::exp(-x)); }
-static float relu(float x)    { return x > 0.0f ? x : 0.0f; }
-static DynamicMatrix softmax(const DynamicMatrix& z) {
-    // get maximum value
-    float maxVal = z.at(0, 0);
-    for (size_t i = 1; i < z.Rows(); i++)
-        maxVal = std::max(maxVal, z.at(i, 0));
+size_t Layer::InSize() const {
+    if (kind == LayerKind::Conv2D) return conv.inChannels * conv.inH * conv.inW;
+    return weights.Cols();
+}
 
-    // matrix output is column vector
-    DynamicMatrix out(z.Rows(), 1);
-    float sum = 0.0f;
-    for (size_t i = 0; i < z.Rows(); i++) {
-        // summation of e^[value - maxVal]
-        out.at(i, 0) = std::exp(z.at(i, 0) - maxVal);
-        sum += out.at(i, 0);
+size_t Layer::OutSize() const {
+    if (kind == LayerKind::Conv2D) return conv.outChannels * conv.outH * conv.outW;
+    return weights.Rows();
+}
+
+DynamicMatrix Layer::preActivation(const DynamicMatrix& input) const {
+    if (kind == LayerKind::Conv2D) {
+        // [outC x C*k*k] * [C*k*k x outH*outW] = one row of outputs per channel
+        const DynamicMatrix cols = Im2Col(input, conv);
+        DynamicMatrix z = halfWeights.Empty() ? weights * cols : halfWeights * cols;
+        const size_t plane = conv.outH * conv.outW;
+        for (size_t oc = 0; oc < conv.outChannels; oc++)
+            for (size_t p = 0; p < plane; p++)
+                z.at(oc, p) += biases.at(oc, 0);
+        // row-major [outC x plane] is already channel-major, just stand it up as a column
+        return z.Reshaped(conv.outChannels * plane, 1);
     }
-    // divide each term by this sum
-    for (size_t i = 0; i < out.Rows(); i++)
-        out.at(i, 0) /= sum;
-    return out;
+    // use our overloads! (half-width weights widen to fp32 inside the multiply)
+    if (!halfWeights.Empty())
+        return halfWeights * input + biases;
+    return weights * input + biases;
 }
 
+DynamicMatrix Layer::activate(const DynamicMatrix& z) const {
+    // one registry lookup per layer, then the kernel runs over the whole column
+    DynamicMatrix a(z.Rows(), z.Cols());
+    GetActivation(activation).forward(z.Data(), a.Data(), z.Size());
+    return a;
+}
 
 DynamicMatrix Layer::forward(const DynamicMatrix& input) const {
-    // use our overloads!
-    DynamicMatrix z = weights * input + biases;
+    return activate(preActivation(input));
+}
+
+DynamicMatrix Layer::activationDelta(const DynamicMatrix& z, const DynamicMatrix& a, const DynamicMatrix& err) const {
+    DynamicMatrix delta(z.Rows(), z.Cols());
+    GetActivation(activation).backward(z.Data(), a.Data(), err.Data(), delta.Data(), z.Size());
+    return delta;
+}
 
-    // if activation is softmax, call special function
-    if (activation == Activation::Softmax) {
-        return softmax(z);
+float Layer::outputDelta(const DynamicMatrix& z, const DynamicMatrix& a, const DynamicMatrix& target, DynamicMatrix& delta) const {
+    constexpr float EPS = 1e-7f;  // clamp for log stability
+    float loss = 0.0f;
+    switch (GetActivation(activation).outputLoss) {
+        case OutputLoss::CrossEntropy:
+            // -sum(y * log(a)), over a softmax
+            for (size_t i = 0; i < a.Rows(); i++)
+                loss -= target.at(i, 0) * std::log(std::max(a.at(i, 0), EPS));
+            delta = a - target;
+            return loss;
+        case OutputLoss::BinaryCrossEntropy:
+            // -sum(y * log(a) + (1 - y) * log(1 - a)), each sigmoid unit its own yes/no
+            for (size_t i = 0; i < a.Rows(); i++) {
+                const float y = target.at(i, 0), ai = a.at(i, 0);
+                loss -= y * std::log(std::max(ai, EPS)) + (1.0f - y) * std::log(std::max(1.0f - ai, EPS));
+            }
+            delta = a - target;
+            return loss;
+        case OutputLoss::SquaredError:
+            break;
     }
+    // 0.5 * sum((a - y)^2), so dLoss/da = a - y, taken back through f'(z)
+    const DynamicMatrix err = a - target;
+    for (size_t i = 0; i < err.Rows(); i++) loss += 0.5f * err.at(i, 0) * err.at(i, 0);
+    delta = activationDelta(z, a, err);
+    return loss;
+}
 
-    // grab activation function
-    const auto fn = activation == Activation::Sigmoid ? sigmoid : relu;
-    // and apply it
-    return z.Apply(fn);
+DynamicMatrix Layer::backpropError(const DynamicMatrix& delta) const {
+    if (kind == LayerKind::Conv2D) {
+        const DynamicMatrix D = delta.Reshaped(conv.outChannels, conv.outH * conv.outW);
+        return Col2Im(weights.Transpose() * D, conv);
+    }
+    return weights.Transpose() * delta;
 }
 
+void Layer::gradients(const DynamicMatrix& delta, const DynamicMatrix& input, DynamicMatrix& dW, DynamicMatrix& dB) const {
+    if (kind == LayerKind::Conv2D) {
+        const DynamicMatrix D = delta.Reshaped(conv.outChannels, conv.outH * conv.outW);
+        // weights are shared across every output position, so their gradient sums over all patches
+        dW = D * Im2Col(input, conv).Transpose();
+        dB = DynamicMatrix(conv.outChannels, 1);
+        for (size_t oc = 0; oc < D.Rows(); oc++)
+            for (size_t p = 0; p < D.Cols(); p++)
+                dB.at(oc, 0) += D.at(oc, p);
+        return;
+    }
+    dW = delta * input.Transpose();
+    dB = delta;
+}
 
 // parse an activation token in config file
 static Activation ParseActivation(const std::string& s) {
-    if (s == "input")   return Activation::Input;
-    if (s == "sigmoid") return Activation::Sigmoid;
-    if (s == "ReLU")    return Activation::ReLU;
-    if (s == "softmax") return Activation::Softmax;
+    if (const ActivationInfo* info = FindActivation(s)) return info->id;
     throw std::runtime_error("Unknown activation: \"" + s + "\"");
 }
 
+// parse a weight storage token ("precision: bf16" in config)
+static WeightPrecision ParsePrecision(const std::string& s) {
+    if (s == "fp32") return WeightPrecision::FP32;
+    if (s == "bf16") return WeightPrecision::BF16;
+    if (s == "fp16") return WeightPrecision::FP16;
+    throw std::runtime_error("Unknown precision: \"" + s + "\"");
+}
+
+// parse an edge culling directive ("edges: topk 16", "edges: threshold 0.05", "edges: all" in config)
+static void ParseEdgeCulling(const std::string& s, EdgeCull& mode, size_t& k, float& threshold) {
+    std::stringstream ss(s);
+    std::string token;
+    ss >> token;
+    if (token == "all") {
+        mode = EdgeCull::All;
+        return;
+    }
+    if (token == "topk") {
+        long long n = 0;
+        if (!(ss >> n) || n <= 0) throw std::runtime_error("edges: topk needs a positive count");
+        mode = EdgeCull::TopK;
+        k = static_cast<size_t>(n);
+        return;
+    }
+    if (token == "threshold") {
+        float t = 0.0f;
+        if (!(ss >> t) || t <= 0.0f || t > 1.0f) throw std::runtime_error("edges: threshold needs a fraction in (0, 1]");
+        mode = EdgeCull::Threshold;
+        threshold = t;
+        return;
+    }
+    throw std::runtime_error("Unknown edge culling: \"" + token + "\"");
+}
+
 struct LayerSpec {
     size_t     neurons;
     Activation activation;
+    LayerKind  kind = LayerKind::Dense;
+    // image shape (input) or output channels + kernel/stride/pad (conv)
+    size_t channels = 0, height = 0, width = 0;
+    size_t kernel = 1, stride = 1, pad = 0;
 };
 
+// parse a positive count out of a config word, e.g. "k3" with prefix "k"
+static size_t ParseCount(const std::string& word, size_t prefixLen) {
+    try {
+        size_t used = 0;
+        const unsigned long v = std::stoul(word.substr(prefixLen), &used);
+        if (used + prefixLen == word.size()) return v;
+    } catch (const std::exception&) {}
+    throw std::runtime_error("Bad number in config: \"" + word + "\"");
+}
+
 // will take a line string and parse into activation tokens
 static LayerSpec ParseLine(const std::string& line) {
     std::vector<std::string> tokens;
@@ -78,20 +232,79 @@ static LayerSpec ParseLine(const std::string& line) {
     if (tokens.empty())
         throw std::runtime_error("Empty layer line in config");
 
+    // the first token may carry extra words after the activation
+    std::vector<std::string> words;
+    std::stringstream ws(tokens[0]);
+    while (ws >> token) words.push_back(token);
+    if (words.empty())
+        throw std::runtime_error("Empty layer token in config");
+
     // the layer spec becomes the number of tokens and the first activation
     // this means you can write like:
     //  "|sigmoid|*|*|*|*|*|"
-    return { tokens.size(), ParseActivation(tokens[0]) };
+    LayerSpec spec{ tokens.size(), ParseActivation(words[0]) };
+    if (words.size() == 1) return spec;
+
+    // image input: "|input 1x28x28|" (or "|input 28x28|" for one channel)
+    if (spec.activation == Activation::Input) {
+        std::vector<size_t> dims;
+        std::stringstream ds(words[1]);
+        while (std::getline(ds, token, 'x')) dims.push_back(ParseCount(token, 0));
+        if (dims.size() == 2) dims.insert(dims.begin(), 1);
+        if (dims.size() != 3)
+            throw std::runtime_error("Input shape must be CxHxW or HxW: \"" + words[1] + "\"");
+        spec.channels = dims[0]; spec.height = dims[1]; spec.width = dims[2];
+        spec.neurons  = dims[0] * dims[1] * dims[2];
+        return spec;
+    }
+
+    // convolution: "|ReLU conv 8 k3 s1 p1|" = 8 output channels, 3x3 kernel, stride 1, padding 1
+    if (words[1] != "conv" || words.size() < 3)
+        throw std::runtime_error("Expected \"<activation> conv <channels> [kN] [sN] [pN]\": \"" + tokens[0] + "\"");
+    spec.kind     = LayerKind::Conv2D;
+    spec.channels = ParseCount(words[2], 0);
+    for (size_t w = 3; w < words.size(); w++) {
+        switch (words[w][0]) {
+            case 'k': spec.kernel = ParseCount(words[w], 1); break;
+            case 's': spec.stride = ParseCount(words[w], 1); break;
+            case 'p': spec.pad    = ParseCount(words[w], 1); break;
+            default: throw std::runtime_error("Unknown conv option: \"" + words[w] + "\"");
+        }
+    }
+    if (spec.channels == 0 || spec.kernel == 0 || spec.stride == 0)
+        throw std::runtime_error("Conv channels, kernel and stride must be positive: \"" + tokens[0] + "\"");
+    return spec;
 }
 
 void NeuralNetwork::FromConfig(const std::string& path) {
+    NN_TRACE_SCOPE("NeuralNetwork::FromConfig");
     std::ifstream file(path);
     if (!file.is_open())
         throw std::runtime_error("Cannot open config file: " + path);
+    FromStream(file);
+}
 
+void NeuralNetwork::FromStream(std::istream& in) {
     std::vector<LayerSpec> specs;
+    WeightPrecision precision = WeightPrecision::FP32;
+    EdgeCull edgeCull = EdgeCull::TopK;
+    size_t   edgeK = DEFAULT_EDGE_K;
+    float    edgeThreshold = DEFAULT_EDGE_THRESHOLD;
     std::string line;
-    while (std::getline(file, line)) {
+    while (std::getline(in, line)) {
+        // optional "precision: bf16" directive selects half-width weight storage
+        if (line.rfind("precision:", 0) == 0) {
+            std::stringstream ss(line.substr(10));
+            std::string token;
+            ss >> token;
+            precision = ParsePrecision(token);
+            continue;
+        }
+        // optional "edges: threshold 0.05" directive picks which edges the renderer gets (top-k per neuron by default)
+        if (line.rfind("edges:", 0) == 0) {
+            ParseEdgeCulling(line.substr(6), edgeCull, edgeK, edgeThreshold);
+            continue;
+        }
         // skip blank lines and those without |
         if (line.find('|') == std::string::npos) continue;
         specs.push_back(ParseLine(line));
@@ -108,11 +321,34 @@ void NeuralNetwork::FromConfig(const std::string& path) {
     // specs[0] = input layer (defines input size only, no weight matrix)
     // specs[1...n] = actual layers with weights
     for (size_t i = 1; i < specs.size(); i++) {
-        size_t inSize  = specs[i - 1].neurons;
-        size_t outSize = specs[i].neurons;
+        LayerSpec& prev = specs[i - 1];
+        LayerSpec& spec = specs[i];
+
+        ConvShape conv;
+        if (spec.kind == LayerKind::Conv2D) {
+            if (prev.channels == 0)
+                throw std::runtime_error("Conv layer " + std::to_string(i) +
+                    " needs an image-shaped input (e.g. |input 1x28x28| or another conv layer)");
+            conv = { prev.channels, prev.height, prev.width, spec.channels, 0, 0,
+                     spec.kernel, spec.stride, spec.pad };
+            if (prev.height + 2 * spec.pad < spec.kernel || prev.width + 2 * spec.pad < spec.kernel)
+                throw std::runtime_error("Conv layer " + std::to_string(i) + " kernel is larger than its padded input");
+            conv.outH = (prev.height + 2 * spec.pad - spec.kernel) / spec.stride + 1;
+            conv.outW = (prev.width  + 2 * spec.pad - spec.kernel) / spec.stride + 1;
+            // the next layer sees this one's feature maps as its image
+            spec.height  = conv.outH;
+            spec.width   = conv.outW;
+            spec.neurons = conv.outChannels * conv.outH * conv.outW;
+        }
+
+        // conv weights are one small kernel bank shared across the whole image
+        const bool isConv = spec.kind == LayerKind::Conv2D;
+        size_t inSize  = isConv ? conv.inChannels * conv.kernel * conv.kernel : prev.neurons;
+        size_t outSize = isConv ? conv.outChannels : spec.neurons;
 
         // Xavier uniform: limit = sqrt(6 / (fan_in + fan_out))
-        float limit = std::sqrt(6.0f / static_cast<float>(inSize + outSize));
+        size_t fanOut = isConv ? conv.outChannels * conv.kernel * conv.kernel : outSize;
+        float limit = std::sqrt(6.0f / static_cast<float>(inSize + fanOut));
         std::uniform_real_distribution<float> dist(-limit, limit);
 
         // create weight matrix based on layer specs
@@ -125,17 +361,116 @@ void NeuralNetwork::FromConfig(const std::string& path) {
         DynamicMatrix biases(outSize, 1);
 
         // use move to define .weights and .bias, and pass activation function
-        mLayers.push_back({ std::move(weights), std::move(biases), specs[i].activation });
+        mLayers.push_back({ std::move(weights), std::move(biases), spec.activation, HalfMatrix(), spec.kind, conv,
+                            0, EdgeList() });
+    }
+
+    mStats.assign(mLayers.size(), LayerStats());
+    for (size_t l = 0; l < mLayers.size(); l++) ScanWeightStats(l);
+    // edge lists are cut on first RefreshEdges, with these settings
+    mEdgeCull = edgeCull;
+    mEdgeK = edgeK;
+    mEdgeThreshold = edgeThreshold;
+    SetWeightPrecision(precision);
+}
+
+void NeuralNetwork::SetWeightPrecision(const WeightPrecision precision) {
+    mPrecision = precision;
+    for (auto& layer : mLayers) {
+        if (precision == WeightPrecision::FP32)
+            layer.halfWeights = HalfMatrix();
+        else
+            layer.halfWeights = HalfMatrix(layer.weights, precision);
+        // weightAt() now reads different storage
+        ++layer.version;
     }
 }
 
+void NeuralNetwork::SetEdgeCulling(const EdgeCull mode, const size_t k, const float threshold) {
+    mEdgeCull = mode;
+    mEdgeK = k;
+    mEdgeThreshold = threshold;
+    // same weights, different picture: anything cached against the old edges is stale too
+    for (auto& layer : mLayers) ++layer.version;
+}
+
+void NeuralNetwork::RefreshEdges() {
+    NN_TRACE_SCOPE("NeuralNetwork::RefreshEdges");
+    for (size_t l = 0; l < mLayers.size(); l++) {
+        Layer& layer = mLayers[l];
+        if (layer.kind != LayerKind::Dense || layer.edges.Current(layer.version)) continue;
+        layer.edges.Configure(mEdgeCull, mEdgeK, mEdgeThreshold);
+        // a threshold is relative to the layer's max |w|, which training already tracks
+        layer.edges.Rebuild(layer.weights.Rows(), layer.weights.Cols(), mStats[l].maxAbsWeight, layer.version,
+                            [&layer](size_t r, size_t c) { return layer.weightAt(r, c); });
+    }
+}
+
+// log2 magnitude bucket, see LayerStats::weightHistogram
+static size_t HistogramBin(const float absW, const size_t bins) {
+    if (absW == 0.0f) return 0;
+    const int b = std::ilogb(absW) + static_cast<int>(bins);
+    return static_cast<size_t>(std::clamp(b, 0, static_cast<int>(bins) - 1));
+}
+
+static float MaxAbs(const DynamicMatrix& m) {
+    float mx = 0.0f;
+    const float* p = m.Data();
+    for (size_t i = 0; i < m.Size(); i++) mx = std::max(mx, std::fabs(p[i]));
+    return mx;
+}
+
+void NeuralNetwork::SetWeightHistogramBins(const size_t bins) {
+    mHistogramBins = bins;
+    for (size_t l = 0; l < mLayers.size(); l++) ScanWeightStats(l);
+}
+
+void NeuralNetwork::ScanWeightStats(const size_t l) {
+    LayerStats& st = mStats[l];
+    st.maxAbsWeight = MaxAbs(mLayers[l].weights);
+    st.weightHistogram.assign(mHistogramBins, 0);
+    if (mHistogramBins == 0) return;
+    const float* w = mLayers[l].weights.Data();
+    for (size_t i = 0; i < mLayers[l].weights.Size(); i++)
+        ++st.weightHistogram[HistogramBin(std::fabs(w[i]), mHistogramBins)];
+}
+
+void NeuralNetwork::UpdateLayer(Layer& layer, LayerStats& stats, const DynamicMatrix& dW, const DynamicMatrix& dB, const float lr) {
+    NN_TRACE_SCOPE("update");
+    // one fused pass: step each weight in place and pick up max |dW|, max |W| and the histogram on the way
+    float* w = layer.weights.Data();
+    const float* g = dW.Data();
+    const size_t n = layer.weights.Size();
+    const bool histogram = mHistogramBins > 0;
+    if (histogram) stats.weightHistogram.assign(mHistogramBins, 0);
+    float maxW = 0.0f, maxG = 0.0f;
+    for (size_t i = 0; i < n; i++) {
+        maxG = std::max(maxG, std::fabs(g[i]));
+        w[i] -= lr * g[i];
+        const float absW = std::fabs(w[i]);
+        maxW = std::max(maxW, absW);
+        if (histogram) ++stats.weightHistogram[HistogramBin(absW, mHistogramBins)];
+    }
+    stats.maxAbsWeight = maxW;
+    stats.maxAbsGrad   = maxG;
+
+    layer.biases  = layer.biases  + dB * (-lr);
+    // forward passes read the half copy, so re-round it from the updated master
+    if (!layer.halfWeights.Empty())
+        layer.halfWeights.Quantize(layer.weights);
+    // edges are recut lazily off this (RefreshEdges), not here on every step
+    ++layer.version;
+}
+
 // run a forward pass and return a vector of all activations!
 std::vector<DynamicMatrix> NeuralNetwork::ForwardAll(const DynamicMatrix& input) const {
     std::vector<DynamicMatrix> acts;
     acts.reserve(mLayers.size() + 1);
     acts.push_back(input);
-    for (const auto& layer : mLayers)
-        acts.push_back(layer.forward(acts.back()));
+    for (size_t l = 0; l < mLayers.size(); l++) {
+        NN_TRACE_SCOPE_ARG("forward", l);
+        acts.push_back(mLayers[l].forward(acts.back()));
+    }
     return acts;
 }
 
@@ -149,44 +484,41 @@ DynamicMatrix NeuralNetwork::forward(const DynamicMatrix& input) const {
     return current;
 }
 
-// ---- activation derivatives ----
-// sigmoid'(a) = a*(1-a)  — takes post-activation value
-static float sigmoidPrime(float a) { return a * (1.0f - a); }
-// relu'(z) = z > 0 ? 1 : 0  — takes pre-activation value
-static float reluPrime(float z)    { return z > 0.0f ? 1.0f : 0.0f; }
-// softmax jacobian applied to error vector: a ⊙ (e - <a,e>)
-static DynamicMatrix softmaxDelta(const DynamicMatrix& a, const DynamicMatrix& e) {
-    float dot = 0.0f;
-    for (size_t i = 0; i < a.Rows(); i++) dot += a.at(i, 0) * e.at(i, 0);
-    DynamicMatrix d(a.Rows(), 1);
-    for (size_t i = 0; i < a.Rows(); i++) d.at(i, 0) = a.at(i, 0) * (e.at(i, 0) - dot);
-    return d;
+// L1 sparsity: add lambda*sign(W) to gradients, return the lambda*|W| loss term
+float NeuralNetwork::AddL1(std::vector<DynamicMatrix>& dW, const float l1) const {
+    float penalty = 0.0f;
+    if (l1 <= 0.0f) return penalty;
+    for (size_t l = 0; l < mLayers.size(); l++) {
+        for (size_t r = 0; r < dW[l].Rows(); r++) {
+            for (size_t c = 0; c < dW[l].Cols(); c++) {
+                float w = mLayers[l].weights.at(r, c);
+                penalty += l1 * std::fabs(w);
+                dW[l].at(r, c) += l1 * (w > 0.0f ? 1.0f : (w < 0.0f ? -1.0f : 0.0f));
+            }
+        }
+    }
+    return penalty;
 }
 
 TrainSnapshot NeuralNetwork::TrainStep(const DynamicMatrix& input,
                                        const DynamicMatrix& target,
                                        float lr, float l1)
 {
+    NN_TRACE_SCOPE("NeuralNetwork::TrainStep");
     const size_t L = mLayers.size();
 
     // === FORWARD — capture z (pre-activation) and a (post-activation) at every layer ===
     std::vector<DynamicMatrix> Z;  Z.reserve(L);
     std::vector<DynamicMatrix> A;  A.reserve(L + 1);
     A.push_back(input);
-    for (const auto& layer : mLayers) {
-        DynamicMatrix z = layer.weights * A.back() + layer.biases;
-        Z.push_back(z);
-        if (layer.activation == Activation::Softmax)
-            A.push_back(softmax(z));
-        else
-            A.push_back(z.Apply(layer.activation == Activation::Sigmoid ? sigmoid : relu));
-    }
-
-    // === LOSS (cross-entropy: -sum(y * log(a))) ===
-    float loss = 0.0f;
-    for (size_t i = 0; i < A.back().Rows(); i++) {
-        float a = std::max(A.back().at(i, 0), 1e-7f);  // clamp for log stability
-        loss -= target.at(i, 0) * std::log(a);
+    for (size_t l = 0; l < L; l++) {
+        NN_TRACE_SCOPE_ARG("forward", l);
+        DynamicMatrix z = mLayers[l].preActivation(A.back());
+        A.push_back(mLayers[l].activate(z));
+        Z.push_back(std::move(z));
+        // each column is scanned once, as it's produced
+        mStats[l].maxAbsIn  = l == 0 ? MaxAbs(A[0]) : mStats[l-1].maxAbsOut;
+        mStats[l].maxAbsOut = MaxAbs(A.back());
     }
 
     // === BACKWARD ===
@@ -194,51 +526,256 @@ TrainSnapshot NeuralNetwork::TrainStep(const DynamicMatrix& input,
     std::vector dW(L,     DynamicMatrix(1, 1));
     std::vector dB(L,     DynamicMatrix(1, 1));
 
-    // output layer: cross-entropy gradient w.r.t. softmax/sigmoid pre-activation = a - y
-    // (softmax+CE and sigmoid+CE both simplify to this — the activation derivative cancels)
-    deltas[L-1] = A[L] - target;
-    dW[L-1] = deltas[L-1] * A[L-1].Transpose();
-    dB[L-1] = deltas[L-1];
+    // output layer: loss and delta by whichever loss its activation trains on
+    float loss = 0.0f;
+    {
+        NN_TRACE_SCOPE_ARG("backward", L - 1);
+        loss = mLayers[L-1].outputDelta(Z[L-1], A[L], target, deltas[L-1]);
+        mStats[L-1].maxAbsDelta = MaxAbs(deltas[L-1]);
+        mLayers[L-1].gradients(deltas[L-1], A[L-1], dW[L-1], dB[L-1]);
+    }
+
+    // ReLU-like activations zero out every delta whose unit is off, so for those dense layers we keep
+    // the nonzero rows and let the gathered kernels skip the rest (both for dW and for the next W^T·δ)
+    std::vector<std::vector<size_t>> activeRows(L);
+    std::vector sparse(L, false);
+    size_t sparseRows = 0, skippedRows = 0;
 
     // hidden layers — walk backward, apply activation derivative here
     for (int l = static_cast<int>(L) - 2; l >= 0; --l) {
-        DynamicMatrix err = mLayers[l+1].weights.Transpose() * deltas[l+1];
-        switch (mLayers[l].activation) {
-            case Activation::Sigmoid:
-                deltas[l] = err.HadamardProduct(A[l+1].Apply(sigmoidPrime)); break;
-            case Activation::ReLU:
-                deltas[l] = err.HadamardProduct(Z[l].Apply(reluPrime));      break;
-            case Activation::Softmax:
-                deltas[l] = softmaxDelta(A[l+1], err);                       break;
+        NN_TRACE_SCOPE_ARG("backward", l);
+        DynamicMatrix err = sparse[l+1]
+            ? mLayers[l+1].weights.TransposeMultiplyRows(deltas[l+1], activeRows[l+1])
+            : mLayers[l+1].backpropError(deltas[l+1]);
+        deltas[l] = mLayers[l].activationDelta(Z[l], A[l+1], err);
+        mStats[l].maxAbsDelta = MaxAbs(deltas[l]);
+        // conv rows share weights across positions, so there's no row to skip there
+        if (GetActivation(mLayers[l].activation).sparseGradient && mLayers[l].kind == LayerKind::Dense) {
+            activeRows[l] = deltas[l].NonZeroRows();
+            sparse[l] = true;
+            sparseRows  += deltas[l].Rows();
+            skippedRows += deltas[l].Rows() - activeRows[l].size();
         }
-        dW[l] = deltas[l] * A[l].Transpose();
-        dB[l] = deltas[l];
-    }
-
-    // === L1 SPARSITY: add lambda*|W| to loss, lambda*sign(W) to gradients ===
-    if (l1 > 0.0f) {
-        for (size_t l = 0; l < L; l++) {
-            for (size_t r = 0; r < dW[l].Rows(); r++) {
-                for (size_t c = 0; c < dW[l].Cols(); c++) {
-                    float w = mLayers[l].weights.at(r, c);
-                    loss += l1 * std::fabs(w);
-                    dW[l].at(r, c) += l1 * (w > 0.0f ? 1.0f : (w < 0.0f ? -1.0f : 0.0f));
-                }
-            }
+        if (sparse[l]) {
+            dW[l] = deltas[l].MultiplyTransposedRows(A[l], activeRows[l]);
+            dB[l] = deltas[l];
+        } else {
+            mLayers[l].gradients(deltas[l], A[l], dW[l], dB[l]);
         }
     }
 
+    // === L1 SPARSITY ===
+    {
+        NN_TRACE_SCOPE("l1");
+        loss += AddL1(dW, l1);
+    }
+
     // === UPDATE WEIGHTS ===
-    for (size_t l = 0; l < L; l++) {
-        mLayers[l].weights = mLayers[l].weights + dW[l] * (-lr);
-        mLayers[l].biases  = mLayers[l].biases  + dB[l] * (-lr);
+    for (size_t l = 0; l < L; l++)
+        UpdateLayer(mLayers[l], mStats[l], dW[l], dB[l], lr);
+
+    TrainSnapshot snap;
+    snap.activations     = std::move(A);
+    snap.deltas          = std::move(deltas);
+    snap.weightGradients = std::move(dW);
+    snap.loss            = loss;
+    snap.skippedDeltaFraction = sparseRows > 0 ? static_cast<float>(skippedRows) / static_cast<float>(sparseRows) : 0.0f;
+    return snap;
+}
+
+// split mLayers into `stages` contiguous groups of roughly equal parameter count.
+// returns stage boundaries: stage s owns layers [bounds[s], bounds[s+1])
+std::vector<size_t> NeuralNetwork::PartitionStages(const size_t stages) const {
+    const size_t L = mLayers.size();
+    size_t total = 0;
+    for (const auto& layer : mLayers) total += layer.weights.Size();
+
+    std::vector<size_t> bounds(stages + 1, 0);
+    bounds[stages] = L;
+    size_t layer = 0, running = 0;
+    for (size_t s = 1; s < stages; s++) {
+        // advance until this stage has its share, but leave at least one layer for every stage after it
+        while (layer < L && running * stages < total * s) running += mLayers[layer++].weights.Size();
+        layer = std::clamp(layer, bounds[s - 1] + 1, L - (stages - s));
+        bounds[s] = layer;
+    }
+    return bounds;
+}
+
+PipelineStats NeuralNetwork::TrainPipelined(const std::vector<DynamicMatrix>& inputs,
+                                            const std::vector<DynamicMatrix>& targets,
+                                            float lr, size_t stages, float l1)
+{
+    using Clock = std::chrono::steady_clock;
+    const size_t L = mLayers.size();
+    const size_t M = inputs.size();
+    if (L == 0)
+        throw std::runtime_error("NeuralNetwork has no layers");
+    if (M == 0 || targets.size() != M)
+        throw std::runtime_error("TrainPipelined: need one target per input micro-batch");
+    // check shapes up front, so a bad batch fails before any stage starts
+    for (size_t m = 0; m < M; m++)
+        if (inputs[m].Rows() != mLayers.front().InSize() || targets[m].Rows() != mLayers.back().OutSize())
+            throw std::runtime_error("TrainPipelined: micro-batch " + std::to_string(m) + " has the wrong shape");
+
+    const size_t S = std::clamp<size_t>(stages, 1, L);
+    const std::vector<size_t> bounds = PartitionStages(S);
+
+    // fwd[s] carries activations s -> s+1, bwd[s] carries errors s+1 -> s.
+    // sized for the whole batch so a producer never has to wait on a full queue
+    struct Message {
+        size_t        micro;
+        DynamicMatrix value;
+    };
+    std::vector<std::unique_ptr<SpscQueue<Message>>> fwd, bwd;
+    for (size_t s = 0; s + 1 < S; s++) {
+        fwd.push_back(std::make_unique<SpscQueue<Message>>(M));
+        bwd.push_back(std::make_unique<SpscQueue<Message>>(M));
     }
 
-    return { A, deltas, dW, loss };
+    // everything a stage writes lives here, so stages never share mutable state
+    struct StageState {
+        std::vector<DynamicMatrix> dW, dB;  // gradient sums for this stage's layers
+        float  loss = 0.0f;                 // only the last stage sees the output
+        double idle = 0.0, wall = 0.0;      // seconds spent waiting on a neighbour / in total
+    };
+    std::vector<StageState> state(S);
+    for (size_t s = 0; s < S; s++) {
+        for (size_t l = bounds[s]; l < bounds[s + 1]; l++) {
+            state[s].dW.emplace_back(mLayers[l].weights.Rows(), mLayers[l].weights.Cols());
+            state[s].dB.emplace_back(mLayers[l].biases.Rows(), mLayers[l].biases.Cols());
+        }
+    }
+
+    auto runStage = [&](const size_t s) {
+        NN_TRACE_SCOPE_ARG("pipeline stage", s);
+        StageState& st = state[s];
+        const size_t first = bounds[s], last = bounds[s + 1];
+        const bool isFirst = s == 0, isLast = s + 1 == S;
+        const auto start = Clock::now();
+
+        auto timedPop = [&st](SpscQueue<Message>& q) {
+            const auto t0 = Clock::now();
+            std::optional<Message> msg = q.Pop();
+            st.idle += std::chrono::duration<double>(Clock::now() - t0).count();
+            // closed: another stage failed, and what it would have sent isn't coming
+            if (!msg) throw std::runtime_error("TrainPipelined: a neighbouring stage failed");
+            return std::move(*msg);
+        };
+
+        // per micro-batch Z/A stash, needed again when its backward comes around (FIFO under 1F1B)
+        struct Stash {
+            size_t micro;
+            std::vector<DynamicMatrix> Z, A;  // A[0] = stage input, A[i+1] = output of layer first+i
+        };
+        std::deque<Stash> inFlight;
+
+        auto forward = [&](const size_t m) {
+            NN_TRACE_SCOPE_ARG("stage forward", m);
+            Stash stash{m, {}, {}};
+            stash.A.push_back(isFirst ? inputs[m] : timedPop(*fwd[s - 1]).value);
+            for (size_t l = first; l < last; l++) {
+                DynamicMatrix z = mLayers[l].preActivation(stash.A.back());
+                stash.A.push_back(mLayers[l].activate(z));
+                stash.Z.push_back(std::move(z));
+            }
+            if (!isLast) fwd[s]->Push({m, stash.A.back()});
+            inFlight.push_back(std::move(stash));
+        };
+
+        auto backward = [&] {
+            NN_TRACE_SCOPE("stage backward");
+            Stash stash = std::move(inFlight.front());
+            inFlight.pop_front();
+            const size_t m = stash.micro;
+
+            DynamicMatrix err = isLast ? DynamicMatrix(1, 1) : timedPop(*bwd[s]).value;
+            for (size_t l = last; l-- > first;) {
+                const size_t i = l - first;
+                // output layer: same loss and delta as TrainStep
+                DynamicMatrix delta(1, 1);
+                if (isLast && l + 1 == last)
+                    st.loss += mLayers[l].outputDelta(stash.Z[i], stash.A[i + 1], targets[m], delta);
+                else
+                    delta = mLayers[l].activationDelta(stash.Z[i], stash.A[i + 1], err);
+                DynamicMatrix dW(1, 1), dB(1, 1);
+                mLayers[l].gradients(delta, stash.A[i], dW, dB);
+                st.dW[i] = st.dW[i] + dW;
+                st.dB[i] = st.dB[i] + dB;
+                if (l > 0) err = mLayers[l].backpropError(delta);
+            }
+            if (!isFirst) bwd[s - 1]->Push({m, std::move(err)});
+        };
+
+        // 1F1B: stage s runs (S-1-s) warm-up forwards, then alternates one forward / one backward,
+        // then drains its remaining backwards. the last stage does F,B,F,B... from the start
+        const size_t warmup = std::min(S - 1 - s, M);
+        size_t issued = 0;
+        for (; issued < warmup; issued++) forward(issued);
+        for (; issued < M; issued++) {
+            forward(issued);
+            backward();
+        }
+        while (!inFlight.empty()) backward();
+
+        st.wall = std::chrono::duration<double>(Clock::now() - start).count();
+    };
+
+    // a stage that throws closes every queue, so its neighbours stop waiting on it and unwind too.
+    // its exception is the one the caller gets, not theirs, and no weights have moved yet
+    std::mutex errorMutex;
+    std::exception_ptr error;
+    auto guardedStage = [&](const size_t s) {
+        try {
+            runStage(s);
+        } catch (...) {
+            {
+                std::lock_guard lock(errorMutex);
+                if (!error) error = std::current_exception();
+            }
+            for (auto& q : fwd) q->Close();
+            for (auto& q : bwd) q->Close();
+        }
+    };
+    // stage 0 on the caller, the rest on this network's long-lived stage threads; each touches only its own layers
+    mStageWorkers.Run(S, guardedStage);
+    if (error) std::rethrow_exception(error);
+
+    // === UPDATE WEIGHTS: average over micro-batches, then the same L1 + step as TrainStep ===
+    const float invM = 1.0f / static_cast<float>(M);
+    std::vector<DynamicMatrix> dW, dB;
+    dW.reserve(L);
+    dB.reserve(L);
+    double idle = 0.0, wall = 0.0;
+    float loss = 0.0f;
+    for (auto& st : state) {
+        for (size_t i = 0; i < st.dW.size(); i++) {
+            dW.push_back(st.dW[i] * invM);
+            dB.push_back(st.dB[i] * invM);
+        }
+        idle += st.idle;
+        wall += st.wall;
+        loss += st.loss;
+    }
+    loss = loss * invM + AddL1(dW, l1);
+    for (size_t l = 0; l < L; l++)
+        UpdateLayer(mLayers[l], mStats[l], dW[l], dB[l], lr);
+
+    PipelineStats stats;
+    stats.loss = loss;
+    stats.bubbleFraction = wall > 0.0 ? static_cast<float>(idle / wall) : 0.0f;
+    stats.stages = S;
+    return stats;
 }
 
 void NeuralNetwork::operator<<(std::ostream &os) const {
     for (const auto& l : mLayers) {
-        os << l.weights.Rows() << "x" << l.weights.Cols() << "(" << ActivationName(l.activation) << ")\n";
+        if (l.kind == LayerKind::Conv2D)
+            os << "conv " << l.conv.inChannels << "x" << l.conv.inH << "x" << l.conv.inW << " -> "
+               << l.conv.outChannels << "x" << l.conv.outH << "x" << l.conv.outW
+               << " k" << l.conv.kernel << " s" << l.conv.stride << " p" << l.conv.pad;
+        else
+            os << l.weights.Rows() << "x" << l.weights.Cols();
+        os << "(" << ActivationName(l.activation) << ", " << PrecisionName(mPrecision) << ")\n";
     }
 }
@@ -5,30 +5,81 @@
 #ifndef NEURAL_NETWORK_CIRCUIT_VISUALIZATION_NEURALNETWORK_H
 #define NEURAL_NETWORK_CIRCUIT_VISUALIZATION_NEURALNETWORK_H
 
+#include <cstdint>
+#include <iosfwd>
 #include <vector>
 #include <string>
+#include "Activation.h"
 #include "DynamicMatrix.h"
-
-// available activation functions
-enum class Activation {Input, Sigmoid, ReLU, Softmax};
-
-inline std::string_view ActivationName(const Activation& a) {
-    switch (a) {
-        case Activation::Input:   return "Input";
-        case Activation::Sigmoid: return "Sigmoid";
-        case Activation::ReLU:    return "ReLU";
-        case Activation::Softmax: return "Softmax";
-    }
-}
+#include "EdgeList.h"
+#include "HalfMatrix.h"
+#include "StageWorkers.h"
+
+// how a layer connects to the column before it
+enum class LayerKind {Dense, Conv2D};
+
+// geometry of a Conv2D layer. activations stay column vectors, flattened channel-major:
+// index = (channel * height + y) * width + x
+struct ConvShape {
+    size_t inChannels  = 0, inH  = 0, inW  = 0;
+    size_t outChannels = 0, outH = 0, outW = 0;
+    size_t kernel = 1, stride = 1, pad = 0;
+};
 
 // Layer wrapper for weights, bias, and activation function
 struct Layer {
-    DynamicMatrix weights;  // shape: [out_neurons x in_neurons]
-    DynamicMatrix biases;   // shape: [out_neurons x 1]
+    DynamicMatrix weights;  // shape: [out_neurons x in_neurons]       (conv: [out_channels x in_channels*k*k])
+    DynamicMatrix biases;   // shape: [out_neurons x 1]                 (conv: [out_channels x 1])
     Activation activation;
-
+    // optional bf16/fp16 copy of weights, read by the forward pass instead of the fp32 master
+    // (the master stays fp32 so small gradient updates aren't rounded away)
+    HalfMatrix halfWeights;
+    LayerKind kind = LayerKind::Dense;
+    ConvShape conv;  // only meaningful for Conv2D
+    // bumped every time the weights this layer exposes change, so renderers can tell a cached picture is stale
+    uint64_t version = 0;
+    // the edges worth drawing (Dense only). stale once version moves on, until NeuralNetwork::RefreshEdges
+    EdgeList edges;
+
+    // neuron counts of the column feeding this layer and the column it produces
+    [[nodiscard]] size_t InSize() const;
+    [[nodiscard]] size_t OutSize() const;
+
+    // z = W*x + b, reading whichever weight storage this layer uses
+    // (Conv2D lowers to the same GEMM through im2col)
+    [[nodiscard]] DynamicMatrix preActivation(const DynamicMatrix& input) const;
+    // a = f(z) through this layer's registered activation kernel
+    [[nodiscard]] DynamicMatrix activate(const DynamicMatrix& z) const;
     // compute a forward pass at this layer, taking in another matrix as input
     [[nodiscard]] DynamicMatrix forward(const DynamicMatrix& input) const;
+
+    // delta = dLoss/dz from err = dLoss/da, using the activation's derivative kernel
+    [[nodiscard]] DynamicMatrix activationDelta(const DynamicMatrix& z, const DynamicMatrix& a, const DynamicMatrix& err) const;
+    // as the output layer: this sample's loss against target, and its delta, by the activation's OutputLoss
+    float outputDelta(const DynamicMatrix& z, const DynamicMatrix& a, const DynamicMatrix& target, DynamicMatrix& delta) const;
+
+    // backward helpers, given this layer's delta (dLoss/dz):
+    // error handed to the previous column (W^T·δ, or col2im(W^T·δ) for conv)
+    [[nodiscard]] DynamicMatrix backpropError(const DynamicMatrix& delta) const;
+    // weight/bias gradients for the input this layer saw
+    void gradients(const DynamicMatrix& delta, const DynamicMatrix& input, DynamicMatrix& dW, DynamicMatrix& dB) const;
+
+    // single weight as seen by the forward pass (half copy if there is one)
+    [[nodiscard]] float weightAt(size_t r, size_t c) const {
+        return halfWeights.Empty() ? weights.at(r, c) : halfWeights.at(r, c);
+    }
+};
+
+// per-layer magnitudes kept current by training, so a renderer can normalize in O(1) instead of rescanning
+struct LayerStats {
+    float maxAbsWeight = 0.0f;  // max |W| (fp32 master)
+    float maxAbsGrad   = 0.0f;  // max |dW| of the last step, L1 term included
+    float maxAbsDelta  = 0.0f;  // max |δ| of the last step
+    float maxAbsIn     = 0.0f;  // max |a| of the column feeding this layer, last training forward pass
+    float maxAbsOut    = 0.0f;  // max |a| this layer produced in it
+    // optional log2 histogram of |W| (see NeuralNetwork::SetWeightHistogramBins). with B bins, bin b counts
+    // |w| in [2^(b-B), 2^(b-B+1)); bin 0 also takes zeros and anything smaller, bin B-1 anything >= 1
+    std::vector<uint32_t> weightHistogram;
 };
 
 struct TrainSnapshot {
@@ -36,17 +87,53 @@ struct TrainSnapshot {
     std::vector<DynamicMatrix> deltas;          // [delta1, ..., deltaL], one per layer
     std::vector<DynamicMatrix> weightGradients; // [dW1, ..., dWL], same shape as weights
     float loss = 0.0f;
+    // share of hidden ReLU delta rows that were exactly zero and skipped by the backward kernels
+    float skippedDeltaFraction = 0.0f;
+    // filled only for snapshots that get drawn (TrainStep leaves it empty, so steps nobody sees don't copy it):
+    std::vector<LayerStats> stats;              // one per layer, NeuralNetwork::Stats() as of the end of this step
+    // filled only by Trainer, for snapshots that cross to the render thread:
+    uint64_t step = 0;                          // how many steps the trainer had taken
+    std::vector<Layer> layers;                  // the network right after this step
+};
+
+// result of one pipeline-parallel training step
+struct PipelineStats {
+    float  loss = 0.0f;            // mean loss over the micro-batches
+    float  bubbleFraction = 0.0f;  // share of total stage time spent idle, waiting on a neighbouring stage
+    size_t stages = 0;             // layer groups actually used (capped at the layer count)
 };
 
 class NeuralNetwork {
     // network consists of a vector of Layer objects
     std::vector<Layer> mLayers;
+    WeightPrecision mPrecision = WeightPrecision::FP32;
+    static constexpr size_t DEFAULT_EDGE_K = 16;
+    static constexpr float  DEFAULT_EDGE_THRESHOLD = 0.05f;
+    EdgeCull mEdgeCull = EdgeCull::TopK;
+    size_t   mEdgeK = DEFAULT_EDGE_K;
+    float    mEdgeThreshold = DEFAULT_EDGE_THRESHOLD;
+    std::vector<LayerStats> mStats;
+    size_t mHistogramBins = 0;
+    StageWorkers mStageWorkers;  // TrainPipelined's stage threads, kept between calls
+
+    // apply one gradient step to a layer's fp32 master weights, then refresh its half copy.
+    // the same pass over the weights fills the weight/gradient fields of stats
+    void UpdateLayer(Layer& layer, LayerStats& stats, const DynamicMatrix& dW, const DynamicMatrix& dB, float lr);
+    // max |W| (and histogram) from scratch, for when weights change outside a training step
+    void ScanWeightStats(size_t l);
+    // L1 sparsity: adds lambda*sign(W) to each dW, returns the lambda*|W| loss term
+    float AddL1(std::vector<DynamicMatrix>& dW, float l1) const;
+    // contiguous layer groups for pipeline stages, balanced by parameter count
+    [[nodiscard]] std::vector<size_t> PartitionStages(size_t stages) const;
 
 public:
     NeuralNetwork() = default;
 
-    // load layers from a config file into this network
+    // load layers from a config file into this network. besides the |layer| lines it takes
+    // "precision: fp32|bf16|fp16" and "edges: topk K | threshold T | all" (see SetEdgeCulling)
     void FromConfig(const std::string& path);
+    // same, from config text already in memory (e.g. a synthesized network)
+    void FromStream(std::istream& in);
 
     // Run a forward pass. Input must be a column vector [input_size x 1].
     [[nodiscard]] DynamicMatrix forward(const DynamicMatrix& input) const;
@@ -56,11 +143,37 @@ public:
     [[nodiscard]] std::vector<DynamicMatrix> ForwardAll(const DynamicMatrix& input) const;
 
     [[nodiscard]] const std::vector<Layer>& Layers() const { return mLayers; }
-
-    // One full training step: forward, backward, weight update. Returns snapshot for animation.
+    // per-layer stats as of the last training step. TrainStep refreshes every field;
+    // TrainPipelined refreshes the weight and gradient ones
+    [[nodiscard]] const std::vector<LayerStats>& Stats() const { return mStats; }
+    // 0 turns the |W| histogram off (the default)
+    void SetWeightHistogramBins(size_t bins);
+
+    // storage used by forward passes. BF16/FP16 halve weight memory traffic;
+    // training still updates fp32 master weights and accumulates in fp32
+    void SetWeightPrecision(WeightPrecision precision);
+    [[nodiscard]] WeightPrecision GetWeightPrecision() const { return mPrecision; }
+
+    // which edges each Dense layer keeps in Layer::edges for the renderer (k for TopK, threshold for Threshold)
+    void SetEdgeCulling(EdgeCull mode, size_t k, float threshold);
+    [[nodiscard]] EdgeCull GetEdgeCulling() const { return mEdgeCull; }
+    // recut the edge list of every Dense layer whose weights changed since its last cut. training doesn't
+    // (that would sort every moved row on every step), so call this before drawing or copying the layers out
+    void RefreshEdges();
+
+    // One full training step: forward, backward, weight update. Returns snapshot for animation
+    // (everything but stats, which the caller copies from Stats() if it's going to draw this one).
     // l1: L1 sparsity regularization coefficient (drives weak weights to exactly zero)
     TrainSnapshot TrainStep(const DynamicMatrix& input, const DynamicMatrix& target, float lr, float l1 = 0.0f);
 
+    // Pipeline-parallel step over a batch of micro-batches (inputs[i] paired with targets[i]).
+    // mLayers is split into `stages` contiguous groups, each on its own thread (kept alive between calls).
+    // Activations flow forward and errors flow back through lock-free SPSC queues on a 1F1B schedule. Each stage
+    // owns its layers, so no weights are replicated; gradients are averaged over the batch and applied once at the end.
+    // If a stage throws, the others are released and the exception is rethrown here with the weights untouched.
+    PipelineStats TrainPipelined(const std::vector<DynamicMatrix>& inputs, const std::vector<DynamicMatrix>& targets,
+                                 float lr, size_t stages, float l1 = 0.0f);
+
      void operator<<(std::ostream& os) const;
 };
 
@@ -4,44 +4,270 @@
 
 #include "NeuralNetworkActor.h"
 #include "DrawComponent.h"
+#include "EdgeLod.h"
 #include "Math.h"
 #include <algorithm>
 #include <cmath>
 #include "Game.h"
+#include "Perf.h"
+#include "Trace.h"
 
 NeuralNetworkActor::NeuralNetworkActor():mWidth(0.0f), mHeight(0.0f) {
     mDraw = CreateComponent<DrawComponent>();
+    mBackDraw = CreateComponent<DrawComponent>();
+    mBackDraw->SetDrawOrder(mDraw->GetDrawOrder() + 1);
 }
 
-Vector2 NeuralNetworkActor::NeuronPos(int col, int neuronIdx, int neuronCount,
-                                      float colStep, float originX, float originY) const
-{
-    // +1 because the height includes half neurons on top/bottom
-    float rowStep = mHeight / static_cast<float>(neuronCount + 1);
+void NeuralNetworkActor::BinSpan(int bin, int bins, int count, float originY, float& centerY, float& spanPx) const {
+    // same row spacing as NetworkLayout::NeuronPos, so a bin of one neuron lands exactly on it
+    float rowStep = mLayout.Height() / static_cast<float>(count + 1);
+    const int first = EdgeLod::First(bin, bins, count);
+    const int last  = EdgeLod::First(bin + 1, bins, count) - 1;
+    centerY = originY + (static_cast<float>(first + last) * 0.5f + 1.0f) * rowStep;
+    spanPx  = static_cast<float>(last - first + 1) * rowStep;
+}
 
-    // simple x and y shifts
-    float x = originX + static_cast<float>(col) * colStep;
-    float y = originY + static_cast<float>(neuronIdx + 1) * rowStep;
-    return {x, y};
+float NeuralNetworkActor::BundleThickness(float srcSpan, float dstSpan) {
+    // half the thinner end's height, so neighbouring bundles keep a gap between them
+    return Math::Clamp(Math::Min(srcSpan, dstSpan) * 0.5f, 1.0f, MAX_BUNDLE_THICKNESS);
 }
 
-float NeuralNetworkActor::NeuronRadius(float colStep, float minRowStep)
-{
-    // total magic number...max for it would be 0.5f
-    // because then these two half radii would kiss
-    return Math::Min(colStep, minRowStep) * 0.36f;
+bool NeuralNetworkActor::CrossesView(float x1, float y1, float x2, float y2, float thickness, const SDL_FRect& view) {
+    const float pad = thickness * 0.5f;
+    const float left = Math::Max(x1, view.x - pad), right = Math::Min(x2, view.x + view.w + pad);
+    if (right < left) return false;
+    // a straight line's y over [left, right] lies between its y at the two ends
+    const float slope = x2 > x1 ? (y2 - y1) / (x2 - x1) : 0.0f;
+    const float ya = y1 + (left - x1) * slope, yb = y1 + (right - x1) * slope;
+    return Math::Max(ya, yb) >= view.y - pad && Math::Min(ya, yb) <= view.y + view.h + pad;
+}
+
+bool NeuralNetworkActor::CrossingSpan(float x1, float x2, float fixedY, bool fixedAtDst, float thickness,
+                                      const SDL_FRect& view, float& lo, float& hi) {
+    const float pad = thickness * 0.5f;
+    const float left = Math::Max(x1, view.x - pad), right = Math::Min(x2, view.x + view.w + pad);
+    if (right < left) return false;
+    const float top = view.y - pad, bottom = view.y + view.h + pad;
+    // u runs from the free end (0) to the fixed one (1), so at u the line's y is free * (1 - u) + fixedY * u,
+    // rising with free. it crosses if y >= top at one end of [left, right] and y <= bottom at one, as in CrossesView
+    const auto u = [&](float x) {
+        const float t = x2 > x1 ? (x - x1) / (x2 - x1) : 0.0f;
+        return fixedAtDst ? t : 1.0f - t;
+    };
+    // the free y that puts the line at `bound` at u. at u = 1 the free end has no say: either any y does or none
+    const auto atLeast = [fixedY](float at, float bound) {
+        if (at < 1.0f) return (bound - fixedY * at) / (1.0f - at);
+        return fixedY >= bound ? -INFINITY : INFINITY;
+    };
+    const auto atMost = [fixedY](float at, float bound) {
+        if (at < 1.0f) return (bound - fixedY * at) / (1.0f - at);
+        return fixedY <= bound ? INFINITY : -INFINITY;
+    };
+    const float ua = u(left), ub = u(right);
+    lo = Math::Min(atLeast(ua, top), atLeast(ub, top));
+    hi = Math::Max(atMost(ua, bottom), atMost(ub, bottom));
+    return lo <= hi;
+}
+
+void NeuralNetworkActor::VisibleBins(int col, int bins, float top, float bottom, int& first, int& last) const {
+    // a bin's center lies between its first and last neuron, so a neuron of any bin whose center is in
+    // [top, bottom] is within one bin's height of it
+    const int count = mLayout.Count(col);
+    const float binPx = static_cast<float>((count + bins - 1) / bins) * mLayout.Height() / static_cast<float>(count + 1);
+    int r0, r1;
+    mLayout.VisibleRows(col, top - binPx, bottom + binPx, r0, r1);
+    first = last = 0;
+    if (r0 == r1) return;
+    // neuron n is in bin n * bins / count
+    first = static_cast<int>(static_cast<long long>(r0) * bins / count);
+    last  = static_cast<int>(static_cast<long long>(r1 - 1) * bins / count) + 1;
+}
+
+void NeuralNetworkActor::VisibleBundles(int c, const EdgeBins& bins, const SDL_FRect& view, std::vector<int>& out) const {
+    out.clear();
+    const float x1 = mLayout.OriginX() + static_cast<float>(c) * mLayout.ColStep(), x2 = x1 + mLayout.ColStep();
+    const float oy = mLayout.OriginY();
+    const float rowStep = mLayout.Height() / static_cast<float>(bins.inCount + 1);
+    // destination bins some source bin can reach the view from: the lowest source end bounds how high they
+    // can sit, the highest how low (every bundle end lies between the column's first and last neuron)
+    float lo, hi, unused;
+    if (!CrossingSpan(x1, x2, oy + static_cast<float>(bins.inCount) * rowStep, false, MAX_BUNDLE_THICKNESS, view, lo, unused)) return;
+    CrossingSpan(x1, x2, oy + rowStep, false, MAX_BUNDLE_THICKNESS, view, unused, hi);
+    int bo0, bo1;
+    VisibleBins(c + 1, bins.outBins, lo, hi, bo0, bo1);
+    for (int bo = bo0; bo < bo1; ++bo) {
+        float dstY, dstSpan;
+        BinSpan(bo, bins.outBins, bins.outCount, oy, dstY, dstSpan);
+        // then the source bins that reach it through the view
+        if (!CrossingSpan(x1, x2, dstY, true, MAX_BUNDLE_THICKNESS, view, lo, hi)) continue;
+        int bi0, bi1;
+        VisibleBins(c, bins.inBins, lo, hi, bi0, bi1);
+        for (int bi = bi0; bi < bi1; ++bi) {
+            float srcY, srcSpan;
+            BinSpan(bi, bins.inBins, bins.inCount, oy, srcY, srcSpan);
+            // the ranges above are padded for the thickest bundle; this one may be thinner
+            if (CrossesView(x1, srcY, x2, dstY, BundleThickness(srcSpan, dstSpan), view))
+                out.push_back(bo * bins.inBins + bi);
+        }
+    }
+    // strong bundles last, on top, as bins.order has them
+    std::sort(out.begin(), out.end(), [&bins](int a, int b) { return bins.meanAbs[a] < bins.meanAbs[b]; });
+}
+
+template<typename F>
+void NeuralNetworkActor::ForEachVisibleEdge(int c, const EdgeList& edges, const SDL_FRect& view, F f) const {
+    const int inCount = mLayout.Count(c);
+    if (inCount == 0) return;
+    const float x1 = mLayout.OriginX() + static_cast<float>(c) * mLayout.ColStep(), x2 = x1 + mLayout.ColStep();
+    // destination rows some source row can reach the view from, as in VisibleBundles
+    float lo, hi, unused;
+    if (!CrossingSpan(x1, x2, mLayout.Center(c, inCount - 1).y, false, EDGE_THICKNESS, view, lo, unused)) return;
+    CrossingSpan(x1, x2, mLayout.Center(c, 0).y, false, EDGE_THICKNESS, view, unused, hi);
+    int j0, j1;
+    mLayout.VisibleRows(c + 1, lo, hi, j0, j1);
+    for (int j = j0; j < j1; ++j) {
+        const Vector2 dst = mLayout.Center(c + 1, j);
+        if (!CrossingSpan(x1, x2, dst.y, true, EDGE_THICKNESS, view, lo, hi)) continue;
+        int i0, i1;
+        mLayout.VisibleRows(c, lo, hi, i0, i1);
+        if (i0 == i1) continue;
+        // rows are short (the whole layer fit the budget, or it'd be drawn as bundles), and weakest first
+        for (const EdgeList::Edge& e : edges.Row(static_cast<size_t>(j))) {
+            const auto i = static_cast<int>(e.in);
+            if (i < i0 || i >= i1) continue;
+            // the span is exact up to rounding at its ends
+            const Vector2 src = mLayout.Center(c, i);
+            if (CrossesView(src.x, src.y, dst.x, dst.y, EDGE_THICKNESS, view)) f(j, e, src, dst);
+        }
+    }
+}
+
+float NeuralNetworkActor::ZoomStep() const {
+    return std::exp2(std::floor(std::log2(mZoom)));
+}
+
+size_t NeuralNetworkActor::ViewEdgeBudget() const {
+    const float step = ZoomStep();
+    if (mEdgeBudget == 0 || step <= 1.0f) return mEdgeBudget;
+    // capped: past this the bins would cost more to fold and keep than the view can show of them
+    const size_t scale = Math::Min(static_cast<size_t>(step), MAX_BUDGET_ZOOM);
+    return Math::Min(mEdgeBudget * scale, MAX_EDGE_BUDGET);
+}
+
+void NeuralNetworkActor::SetEdgeBudget(size_t budget) {
+    mEdgeBudget = budget;
+    SDL_Log("edge budget: %zu bundles per layer", mEdgeBudget);
+    MarkDirty();
+    // bins may change, so every cached layer picture is stale (gradient meshes key on the budget themselves)
+    mWeightCache.Invalidate();
 }
 
 void NeuralNetworkActor::SetNN(NeuralNetwork nn) {
     mNN = std::move(nn);
+    MarkDirty();
+    // a fresh network restarts layer versions at zero
+    mWeightCache.Invalidate();
+    mLayerBins.clear();
+}
+
+void NeuralNetworkActor::BakeWeights(SDL_Renderer* renderer, int c, const Layer& W, float maxAbsWeight,
+                                     const SDL_FRect& area) {
+    NN_TRACE_SCOPE("BakeWeights");
+    // weight columns is num input rows
+    int inCount  = static_cast<int>(W.weights.Cols());
+    // weight rows is num output rows
+    int outCount = static_cast<int>(W.weights.Rows());
+    // lines are picked in screen coordinates, then drawn relative to the texture
+    const float tx = area.x, ty = area.y;
+
+    // too many edges for the budget, or too many neurons for the pixels: draw bin-to-bin bundles instead
+    int inBins, outBins;
+    EdgeLod::ChooseBins(inCount, outCount, LodHeight(), ViewEdgeBudget(), inBins, outBins);
+    if (inBins != inCount || outBins != outCount) {
+        // folding every weight is the expensive part, and a camera move doesn't change it
+        LayerBins& cached = mLayerBins[c];
+        if (!cached.bins.Matches(inCount, outCount, inBins, outBins) || cached.version != W.version) {
+            EdgeLod::Aggregate(cached.bins, inCount, outCount, inBins, outBins,
+                               [&W](size_t j, size_t i) { return W.weightAt(j, i); });
+            cached.version = W.version;
+        }
+        const EdgeBins& bins = cached.bins;
+        // an all-zero layer has nothing to draw (and nothing to normalize by)
+        if (bins.maxMeanAbs == 0.0f) return;
+        const float srcX = mLayout.OriginX() + static_cast<float>(c) * mLayout.ColStep() - tx;
+        const float dstX = srcX + mLayout.ColStep();
+        VisibleBundles(c, bins, area, mVisibleBundles);
+        for (int k : mVisibleBundles) {
+            const int bo = k / inBins, bi = k % inBins;
+            float srcY, srcSpan, dstY, dstSpan;
+            BinSpan(bi, inBins, inCount, mLayout.OriginY() - ty, srcY, srcSpan);
+            BinSpan(bo, outBins, outCount, mLayout.OriginY() - ty, dstY, dstSpan);
+            // same color rule as single edges, on the bundle's mean
+            float normalized = bins.meanAbs[k] / bins.maxMeanAbs;
+            auto grayscale = Math::Clamp(normalized * 255.0f, 30.0f, 255.0f) / 255.0f;
+            const bool positive = bins.meanSigned[k] >= 0.0f;
+            const SDL_FColor color = {grayscale, positive ? grayscale : 0.0f, positive ? grayscale : 0.0f, 1.0f};
+            mEdgeBatch.AddLine(srcX, srcY, dstX, dstY, BundleThickness(srcSpan, dstSpan), color);
+        }
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+        mEdgeBatch.Submit(renderer);
+        mEdgeBatch.Clear();
+        return;
+    }
+
+    // only the edges worth drawing (top-k per neuron or above the threshold), weakest first,
+    // normalized by the layer's max |w| that training keeps anyway
+    const float maxMag = maxAbsWeight;
+    if (maxMag == 0.0f) return;
+    ForEachVisibleEdge(c, W.edges, area, [&](int, const EdgeList::Edge& e, const Vector2& src, const Vector2& dst) {
+        float w = e.weight;
+        // normalize so the strongest weight in this layer maps to full brightness
+        float normalized = std::fabs(w) / maxMag;
+        auto grayscale = Math::Clamp(normalized * 255.0f, 30.0f, 255.0f) / 255.0f;
+
+        // positive weights stay grayscale; negative weights are red (bright red = large magnitude, dark red = small)
+        const SDL_FColor color = {grayscale, w >= 0.0f ? grayscale : 0.0f, w >= 0.0f ? grayscale : 0.0f, 1.0f};
+        mEdgeBatch.AddLine(src.x - tx, src.y - ty, dst.x - tx, dst.y - ty, EDGE_THICKNESS, color);
+    });
+    // opaque lines straight into the (transparent) target, no blending against it
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+    mEdgeBatch.Submit(renderer);
+    mEdgeBatch.Clear();
 }
 
-void NeuralNetworkActor::DrawWeights(size_t totalCols, const std::vector<Layer>& layers, float colStep, float ox, float oy) const {
-    const float animP = 1.0f - mForwardTimer/ANIMATION_DURATION;
+void NeuralNetworkActor::DrawWeights(const std::vector<Layer>& layers) {
+    NN_TRACE_SCOPE("DrawWeights");
+    const int totalCols = mLayout.Columns();
+    const float colStep = mLayout.ColStep();
+    const float ox = mLayout.OriginX(), oy = mLayout.OriginY();
+    const float animP = AnimProgress(mForwardTimer);
     const auto fCols = static_cast<float>(totalCols);
-    // for each column (except the last, which points nowhere)
-    for (int c = 0; c + 1 < totalCols; ++c)
+    SDL_Renderer* renderer = gGame.GetRenderer();
+
+    const SDL_FRect& view = mViewport;
+    const std::vector<LayerStats>& stats = ViewStats();
+    if (mLayerBins.size() < layers.size()) mLayerBins.resize(layers.size());
+    if (mBakeKeys.size() < layers.size()) mBakeKeys.resize(layers.size());
+
+    // each layer's texture covers its column gap plus a margin so the end caps of the thick lines aren't clipped,
+    // but never more than the viewport: zoomed in, it holds only the part on screen. its size only depends
+    // on the zoom, so panning redraws into the same textures
+    constexpr float MARGIN = 2.0f;
+    const float gapW = colStep + 2.0f * MARGIN, gapH = mLayout.Height() + 2.0f * MARGIN;
+    const int texW = static_cast<int>(std::ceil(Math::Min(gapW, view.w)));
+    const int texH = static_cast<int>(std::ceil(Math::Min(gapH, view.h)));
+    const float y0 = Math::Max(oy - MARGIN, view.y);
+    if (Math::Min(oy - MARGIN + gapH, view.y + view.h) <= y0) return;
+
+    // for each column (except the last, which points nowhere) whose gap the viewport shows
+    int first, last;
+    mLayout.VisibleColumns(view.x - gapW, view.x + view.w + MARGIN, first, last);
+    for (int c = first; c < Math::Min(last, totalCols - 1); ++c)
     {
+        const float gapX = ox + static_cast<float>(c) * colStep - MARGIN;
+        const float x0 = Math::Max(gapX, view.x);
+        if (Math::Min(gapX + gapW, view.x + view.w) <= x0) continue;
+
         // how far (in seconds) through [c->c+1]'s interval...
         // say animP is a 0.375 and c=1, fCols=4...animP - c/fCols = 0.375 - 0.25 = 0.125
         float phase = animP - static_cast<float>(c) / fCols;
@@ -50,291 +276,517 @@ void NeuralNetworkActor::DrawWeights(size_t totalCols, const std::vector<Layer>&
         phase *= fCols;
         float colBrightness = Math::Clamp( phase, 0.0f, 1.0f);
         float swell = Math::Clamp(1.0f - std::fabs(phase - 1.0f), 0.0f, 1.0f);
-
-        // get the weight matrix that transforms to next column
-        const DynamicMatrix& W = layers[c].weights;
-        // weight columns is num input rows
-        int inCount  = static_cast<int>(W.Cols());
-        // weight rows is num output rows
-        int outCount = static_cast<int>(W.Rows());
-
-        // find the largest absolute weight in this layer so we can normalize against it
-        float maxMag = 0.0f;
-        for (int i = 0; i < inCount; ++i) {
-            for (int j = 0; j < outCount; ++j) {
-                maxMag = std::max(maxMag, std::fabs(W.at(static_cast<size_t>(j), static_cast<size_t>(i))));
-            }
+        // nothing to show yet, and no reason to (re)bake
+        if (colBrightness <= 0.0f) continue;
+
+        // get the layer that transforms to next column (reads its half-width weights if it has them)
+        const Layer& W = layers[c];
+        // conv kernels are shared across positions, there's no one-line-per-weight picture to draw
+        if (W.kind != LayerKind::Dense) continue;
+
+        // the static picture only changes with this layer's weights (version), the scale, or where the column
+        // falls in the texture. the last stays put while the whole gap is in view, however it's panned
+        const SDL_FRect dst = {x0, y0, static_cast<float>(texW), static_cast<float>(texH)};
+        BakeKey& key = mBakeKeys[c];
+        const float kx = ox + static_cast<float>(c) * colStep - x0, ky = oy - y0;
+        // sub-pixel wobble from subtracting screen coordinates isn't a move
+        constexpr float SAME_PIXELS = 1.0f / 64.0f;
+        if (key.version != W.version || std::fabs(key.x - kx) > SAME_PIXELS || std::fabs(key.y - ky) > SAME_PIXELS
+            || key.colStep != colStep || key.height != mLayout.Height()) {
+            key = {W.version, kx, ky, colStep, mLayout.Height(), key.stamp + 1};
+        }
+        SDL_Texture* tex = mWeightCache.Acquire(renderer, static_cast<size_t>(c), texW, texH, key.stamp,
+            [&](SDL_Renderer* r) { BakeWeights(r, c, W, stats[c].maxAbsWeight, dst); });
+        if (!tex) continue;
+
+        // fade in with the forward pass...
+        mDraw->AddTexture(tex, dst, 255, 255, 255, static_cast<Uint8>(255.0f * colBrightness));
+        // ...and the swell is the same picture added on top of itself, brightening toward white as it peaks
+        if (swell > 0.0f) {
+            auto boost = static_cast<Uint8>(255.0f * swell);
+            mDraw->AddTexture(tex, dst, boost, boost, boost, static_cast<Uint8>(255.0f * colBrightness), SDL_BLENDMODE_ADD);
         }
+    }
+}
 
-        // for each FROM
-        for (int i = 0; i < inCount; ++i)
-        {
-            // get its neuron position
-            Vector2 src = NeuronPos(c, i, inCount, colStep, ox, oy);
-            // and draw lines for each TO neuron it points to
-            for (int j = 0; j < outCount; ++j)
-            {
-                // TO neuron position
-                Vector2 dst = NeuronPos(c + 1, j, outCount, colStep, ox, oy);
-
-                float w = W.at(static_cast<size_t>(j), static_cast<size_t>(i));
-                // normalize so the strongest weight in this layer maps to alpha 255
-                float normalized = std::fabs(w) / maxMag;
-                auto grayscale = static_cast<Uint8>(Math::Clamp(normalized * 255.0f, 30.0f, 255.0f));
-                // swell pushes grayscale toward white at phase==1, then settles back
-                auto swellGray = static_cast<Uint8>(Math::Clamp(static_cast<float>(grayscale) + swell * (255.0f - static_cast<float>(grayscale)), 0.0f, 255.0f));
-
-                // positive weights stay grayscale; negative weights are red (bright red = large magnitude, dark red = small)
-                Uint8 r = swellGray;
-                Uint8 g = (w >= 0.0f) ? swellGray : 0;
-                Uint8 b = (w >= 0.0f) ? swellGray : 0;
-
-                int thickness = 2 + static_cast<int>(swell * 3.0f);
-                mDraw->AddLine(src.x, src.y, dst.x, dst.y, r, g, b, static_cast<Uint8>(255.0f * colBrightness), thickness);
-            }
+void NeuralNetworkActor::UpdateTiles() {
+    const SDL_FRect& v = mViewport;
+    const bool sameView = v.x == mTilesView.x && v.y == mTilesView.y && v.w == mTilesView.w && v.h == mTilesView.h;
+    if (mTilesGen == mLayout.Generation() && sameView && !mTiles.empty()) return;
+    mTilesGen = mLayout.Generation();
+    mTilesView = v;
+    mTiles.clear();
+    // neurons that wouldn't cover a pixel even swollen to 1.5x aren't drawn at all
+    const float reach = mLayout.Radius() * 1.5f;
+    if (reach >= MIN_NEURON_PIXELS) {
+        // only the columns and rows the viewport shows, reach included so a neuron half in view still is
+        int c0, c1;
+        mLayout.VisibleColumns(mViewport.x - reach, mViewport.x + mViewport.w + reach, c0, c1);
+        for (int c = c0; c < c1; ++c) {
+            int first, last;
+            mLayout.VisibleRows(c, mViewport.y - reach, mViewport.y + mViewport.h + reach, first, last);
+            for (int n = first; n < last; n += NEURONS_PER_TILE)
+                mTiles.push_back({c, n, Math::Min(n + NEURONS_PER_TILE, last)});
         }
     }
+    // only ever grown, so panning back and forth doesn't reallocate command buffers
+    if (mNeuronCmds.size() < mTiles.size()) {
+        mNeuronCmds.resize(mTiles.size());
+        mBackNeuronCmds.resize(mTiles.size());
+    }
 }
 
-void NeuralNetworkActor::DrawNeurons(size_t totalCols, const std::vector<Layer>& layers, const std::vector<int>& neuronCounts,
-                                       float colStep, float ox, float oy, float radius) {
-    const float animP = 1.0f - mForwardTimer/ANIMATION_DURATION;
-    const auto fCols = static_cast<float>(totalCols);
+void NeuralNetworkActor::ForEach(size_t count, const std::function<void(size_t)>& fn) const {
+    if (mParallelRender) {
+        gGame.GetThreadPool().ParallelFor(count, fn);
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) fn(i);
+}
 
-    // for each column
-    for (int c = 0; c < totalCols; ++c)
-    {
-        float phase = animP - static_cast<float>(c-1) / fCols;
-        phase *= fCols;
-        float colBrightness = Math::Clamp( phase, 0.0f, 1.0f);
-        // triangle peaked at phase==1: grows in, peaks, shrinks back to base radius
-        float swell = Math::Clamp(1.0f - std::fabs(phase - 1.0f), 0.0f, 1.0f);
-        float colRadius = radius + (radius * 0.5f) * swell;
+void NeuralNetworkActor::SetParallelRender(bool parallel) {
+    mParallelRender = parallel;
+    const float serial = mBuildMs[0], par = mBuildMs[1];
+    SDL_Log("render commands built %s on %zu workers. avg build: serial %.3f ms, parallel %.3f ms (%.2fx)",
+            mParallelRender ? "in parallel" : "serially", gGame.GetThreadPool().Workers(),
+            serial, par, par > 0.0f ? serial / par : 0.0f);
+}
 
-        // how many neurons
-        int nCount = neuronCounts[c];
+void NeuralNetworkActor::DrawNeurons(const std::vector<Layer>& layers) {
+    NN_TRACE_SCOPE("DrawNeurons");
+    // interning writes the shared table, so every column's label is resolved before the fan-out
+    mColumnLabels.resize(static_cast<size_t>(mLayout.Columns()));
+    for (int c = 0; c < mLayout.Columns(); ++c) {
+        const ActivationInfo& act = GetActivation(c == 0 ? Activation::Input : layers[c - 1].activation);
+        mColumnLabels[c] = gGame.GetGlyphAtlas().Intern(act.label);
+    }
 
-        // activation func
-        bool isInput = c == 0;
-        Activation act{};
-        if (!isInput) {
-            // -1 because the layer is the weight-bias-activation that comes to this (the i-th) column
-            act = layers[c - 1].activation;
-        }
+    // each tile fills its own slice; merging them in tile order is the serial order
+    ForEach(mTiles.size(), [&](size_t t) { NeuronTile(mTiles[t], layers, mNeuronCmds[t]); });
+    for (size_t t = 0; t < mTiles.size(); ++t) mDraw->Append(mNeuronCmds[t]);
+}
 
-        // color each neuron by activation type
-        // let's alpha scale them by their value in a forward()....
-        Uint8 cr = 0, cg = 0, cb = 0;
-        if (isInput) {
-            cr = 200; cg = 200; cb = 200;   // white-gray
-        } else {
-            switch (act) {
-                case Activation::Sigmoid:
-                    cr = 80;  cg = 140; cb = 255; break;  // blue
-                case Activation::ReLU:
-                    cr = 80;  cg = 220; cb = 100; break;  // green
-                case Activation::Softmax:
-                    cr = 255; cg = 160; cb = 50;  break;  // orange
-            }
-        }
+void NeuralNetworkActor::NeuronTile(const RenderTile& tile, const std::vector<Layer>& layers, DrawComponent::Commands& out) const {
+    NN_TRACE_SCOPE_ARG("NeuronTile", tile.col);
+    out.Clear();
+    const int c = tile.col;
+    const int totalCols = mLayout.Columns();
+    const float radius = mLayout.Radius();
+    const float animP = AnimProgress(mForwardTimer);
+    const auto fCols = static_cast<float>(totalCols);
 
-        // Label character
-        std::string label;
-        if (!isInput) {
-            switch (act) {
-                case Activation::Sigmoid: label += "sig"; break;
-                case Activation::ReLU:    label += "ReLU"; break;
-                case Activation::Softmax: label += "SM"; break;
-            }
-        }
-        // relu is unbounded so normalize by the layer's max activation;
-        // sigmoid/softmax are already in [0,1] so scale = 1.0
-        float alphaScale = 1.0f;
-        if (isInput || act == Activation::ReLU) {
-            float maxAct = 0.0f;
-            for (int k = 0; k < nCount; ++k)
-                maxAct = std::max(maxAct, std::fabs(mLastActivation[c].at(static_cast<size_t>(k), 0)));
-            alphaScale = (maxAct > 0.0f) ? 1.0f / maxAct : 0.0f;
-        }
+    float phase = animP - static_cast<float>(c-1) / fCols;
+    phase *= fCols;
+    float colBrightness = Math::Clamp( phase, 0.0f, 1.0f);
+    // triangle peaked at phase==1: grows in, peaks, shrinks back to base radius
+    float swell = Math::Clamp(1.0f - std::fabs(phase - 1.0f), 0.0f, 1.0f);
+    float colRadius = radius + (radius * 0.5f) * swell;
+
+    // activation func (column 0 is the input, which the registry also describes)
+    // -1 because the layer is the weight-bias-activation that comes to this (the i-th) column
+    const ActivationInfo& act = GetActivation(c == 0 ? Activation::Input : layers[c - 1].activation);
+
+    // color each neuron by activation type
+    // let's alpha scale them by their value in a forward()....
+    const Uint8 cr = act.r, cg = act.g, cb = act.b;
+
+    // Label character, interned so every neuron's label is just an id
+    const std::string_view label = act.label;
+    const GlyphAtlas::Label labelId = mColumnLabels[c];
+    // unbounded activations (relu, input...) normalize by the layer's max activation;
+    // sigmoid/softmax are already in [0,1] so scale = 1.0
+    float alphaScale = 1.0f;
+    if (act.normalizeByMax) {
+        // per-column max comes with the snapshot, no rescan
+        const float maxAct = mLastColumnMax[c];
+        alphaScale = (maxAct > 0.0f) ? 1.0f / maxAct : 0.0f;
+    }
 
-        // do this here because all activations are same in a layer
-        const auto len = static_cast<float>(label.size());
-        float textScale = colRadius * 2.0f / (len * Game::CHAR_PIXELS);
-        float halfChar  = Game::HALF_CHAR_PIXELS * textScale;
-        for (int n = 0; n < nCount; ++n)
-        {
-            Vector2 pos = NeuronPos(c, n, nCount, colStep, ox, oy);
+    // do this here because all activations are same in a layer
+    const auto len = static_cast<float>(label.size());
+    float textScale = colRadius * 2.0f / (len * Game::CHAR_PIXELS);
+    float halfChar  = Game::HALF_CHAR_PIXELS * textScale;
+    // too small to read is just quads
+    const bool labeled = textScale * Game::CHAR_PIXELS >= MIN_LABEL_PIXELS;
+    for (int n = tile.first; n < tile.last; ++n)
+    {
+        Vector2 pos = mLayout.Center(c, n);
 
-            float val  = std::fabs(mLastActivation[c].at(static_cast<size_t>(n), 0));
-            auto  alpha = static_cast<Uint8>(Math::Clamp(val * alphaScale * 255.0f, 0.0f, 255.0f));
+        float val  = std::fabs(mLastActivation[c].at(static_cast<size_t>(n), 0));
+        auto  alpha = static_cast<Uint8>(Math::Clamp(val * alphaScale * 255.0f, 0.0f, 255.0f));
 
-            mDraw->AddFilledCircle(pos.x, pos.y, colRadius, cr, cg, cb, static_cast<Uint8>(alpha * colBrightness));
-            mDraw->AddText(pos.x - halfChar * len, pos.y - halfChar, label, textScale);
-        }
+        out.AddFilledCircle(pos.x, pos.y, colRadius, cr, cg, cb, static_cast<Uint8>(alpha * colBrightness));
+        if (labeled) out.AddText(pos.x - halfChar * len, pos.y - halfChar, labelId, textScale);
     }
 }
 
 void NeuralNetworkActor::StartGraphicForward() {
     mForwardTimer = ANIMATION_DURATION;
     mBackwardTimer = 0.0f;
-    auto inp = DynamicMatrix(mNN.Layers()[0].weights.Cols(), 1);
-    float x = 1.0f;
-    inp = inp.Apply([&x](float){ x += 1.2f; return x; });
-    mLastActivation = mNN.ForwardAll(inp);
+    DynamicMatrix inp(1, 1), target(1, 1);
+    TrainingExample(inp, target);
+    {
+        Perf::PhaseScope phase(Perf::FORWARD);
+        mLastActivation = mNN.ForwardAll(inp);
+    }
+    // a plain forward pass has no training stats, so scan each column once here rather than every frame
+    mLastColumnMax.assign(mLastActivation.size(), 0.0f);
+    for (size_t c = 0; c < mLastActivation.size(); ++c)
+        for (size_t k = 0; k < mLastActivation[c].Rows(); ++k)
+            mLastColumnMax[c] = std::max(mLastColumnMax[c], std::fabs(mLastActivation[c].at(k, 0)));
 }
 
-void NeuralNetworkActor::StartGraphicTrain() {
+void NeuralNetworkActor::TrainingExample(DynamicMatrix& input, DynamicMatrix& target) const {
     // hardcoded input: incrementing values
-    auto inp = DynamicMatrix(mNN.Layers()[0].weights.Cols(), 1);
+    input = DynamicMatrix(mNN.Layers()[0].InSize(), 1);
     float x = 1.0f;
-    inp = inp.Apply([&x](float){ x += 1.2f; return x; });
+    input = input.Apply([&x](float){ x += 1.2f; return x; });
 
     // hardcoded target: one-hot [1, 0, 0, ...]
-    size_t outSize = mNN.Layers().back().weights.Rows();
-    DynamicMatrix target(outSize, 1);
+    target = DynamicMatrix(mNN.Layers().back().OutSize(), 1);
     target.at(0, 0) = 1.0f;
+}
 
-    TrainSnapshot snap = mNN.TrainStep(inp, target, 0.075f, 0.005f);
-    mLastActivation  = snap.activations;
-    mLastDeltas      = snap.deltas;
-    mLastWeightGrads = snap.weightGradients;
+void NeuralNetworkActor::ApplySnapshot(TrainSnapshot&& snap) {
+    mLastActivation  = std::move(snap.activations);
+    mLastDeltas      = std::move(snap.deltas);
+    mLastWeightGrads = std::move(snap.weightGradients);
+    // swapped, so a trainer's snapshot slot gets a same-sized stats buffer back to copy the next publish into
+    mLastStats.swap(snap.stats);
+    mLastColumnMax.assign(mLastStats.size() + 1, 0.0f);
+    if (!mLastStats.empty()) mLastColumnMax[0] = mLastStats[0].maxAbsIn;
+    for (size_t l = 0; l < mLastStats.size(); ++l)
+        mLastColumnMax[l + 1] = mLastStats[l].maxAbsOut;
+    ++mSnapshotGen;
+    MarkDirty();
+}
 
-    SDL_Log("loss: %.4f", snap.loss);
+void NeuralNetworkActor::StartGraphicTrain() {
+    DynamicMatrix inp(1, 1), target(1, 1);
+    TrainingExample(inp, target);
+
+    const Uint64 start = SDL_GetPerformanceCounter();
+    TrainSnapshot snap = [&] {
+        Perf::PhaseScope phase(Perf::TRAIN_STEP);
+        return mNN.TrainStep(inp, target, LEARNING_RATE, L1_STRENGTH);
+    }();
+    snap.stats = mNN.Stats();
+    mSyncStepMs = static_cast<float>(SDL_GetPerformanceCounter() - start) * Game::MS_PER_SEC
+                / static_cast<float>(SDL_GetPerformanceFrequency());
+    ++mSyncSteps;
+    SDL_Log("loss: %.4f  (skipped %.0f%% of ReLU deltas)", snap.loss, snap.skippedDeltaFraction * 100.0f);
+    ApplySnapshot(std::move(snap));
 
     mForwardTimer  = ANIMATION_DURATION;
     mBackwardTimer = 0.0f;
 }
 
-void NeuralNetworkActor::DrawBackwardWeights(size_t totalCols, float colStep, float ox, float oy) const {
-    if (mLastWeightGrads.empty()) return;
-    const float animP = 1.0f - mBackwardTimer / ANIMATION_DURATION;
-    const float fCols = static_cast<float>(totalCols);
+void NeuralNetworkActor::SetTraining(bool training) {
+    if (mTrainer.Running()) return;
+    mIsTraining = training;
+    if (mIsTraining) {
+        mBudgetTraining = false;
+        StartGraphicTrain();
+    }
+}
 
-    for (int c = 0; c + 1 < totalCols; ++c) {
-        // reversed: last weight group (rightmost) fires first
-        int rev = static_cast<int>(totalCols) - 2 - c;
-        float phase = animP - static_cast<float>(rev) / fCols;
-        phase *= fCols;
-        float colBrightness = Math::Clamp(phase, 0.0f, 1.0f);
-        float swell = Math::Clamp(1.0f - std::fabs(phase - 1.0f), 0.0f, 1.0f);
+void NeuralNetworkActor::SetBudgetedTraining(bool on) {
+    if (mTrainer.Running()) return;
+    mBudgetTraining = on;
+    if (!mBudgetTraining) return;
+    mIsTraining = false;
+    // measure again from scratch rather than trust whatever the last session ended on
+    mBudgetStepMs  = 0.0f;
+    // the first frames measure the step cost; until then the animation pulses over whatever was last shown
+    mForwardTimer  = ANIMATION_DURATION;
+    mBackwardTimer = 0.0f;
+}
 
-        const DynamicMatrix& dW = mLastWeightGrads[c];
-        int inCount  = static_cast<int>(dW.Cols());
-        int outCount = static_cast<int>(dW.Rows());
-
-        float maxMag = 0.0f;
-        for (int i = 0; i < inCount; ++i)
-            for (int j = 0; j < outCount; ++j)
-                maxMag = std::max(maxMag, std::fabs(dW.at(j, i)));
-        if (maxMag == 0.0f) continue;
-
-        for (int i = 0; i < inCount; ++i) {
-            Vector2 src = NeuronPos(c, i, inCount, colStep, ox, oy);
-            for (int j = 0; j < outCount; ++j) {
-                Vector2 dst = NeuronPos(c + 1, j, outCount, colStep, ox, oy);
-                float normalized = std::fabs(dW.at(j, i)) / maxMag;
-                // red-orange base, swell toward white
-                float baseR = Math::Clamp(normalized * 255.0f, 30.0f, 255.0f);
-                auto swellR = static_cast<Uint8>(baseR + swell * (255.0f - baseR));
-                auto swellG = static_cast<Uint8>(80.0f  + swell * (255.0f - 80.0f));
-                auto swellB = static_cast<Uint8>(50.0f  + swell * (255.0f - 50.0f));
-                int thickness = 1 + static_cast<int>(swell * 3.0f);
-                mDraw->AddLine(src.x, src.y, dst.x, dst.y, swellR, swellG, swellB,
-                               static_cast<Uint8>(255.0f * colBrightness), thickness);
-            }
+size_t NeuralNetworkActor::TrainFor(float budgetMs) {
+    if (!mBudgetTraining || mTrainer.Running()) return 0;
+    NN_TRACE_SCOPE("NeuralNetworkActor::TrainFor");
+    DynamicMatrix inp(1, 1), target(1, 1);
+    TrainingExample(inp, target);
+
+    const auto freq = static_cast<float>(SDL_GetPerformanceFrequency());
+    const Uint64 start = SDL_GetPerformanceCounter();
+    Uint64 stepStart = start;
+    size_t steps = 0;
+    TrainSnapshot snap;
+    // only start a step that's expected to finish in time. an unmeasured network gets one try
+    while (static_cast<float>(stepStart - start) * Game::MS_PER_SEC / freq + mBudgetStepMs <= budgetMs) {
+        {
+            Perf::PhaseScope phase(Perf::TRAIN_STEP);
+            snap = mNN.TrainStep(inp, target, LEARNING_RATE, L1_STRENGTH);
         }
+        const Uint64 now = SDL_GetPerformanceCounter();
+        mSyncStepMs = static_cast<float>(now - stepStart) * Game::MS_PER_SEC / freq;
+        // jump up to a slow step at once so the next frames don't overrun, and come down gradually
+        mBudgetStepMs = mSyncStepMs > mBudgetStepMs ? mSyncStepMs : mBudgetStepMs + (mSyncStepMs - mBudgetStepMs) * 0.1f;
+        stepStart = now;
+        ++steps;
+    }
+    if (steps == 0) {
+        // nothing fit. the estimate may be one preempted or page-faulting step, and it only learns
+        // the real cost by running again, so let it shrink until a step is tried
+        mBudgetStepMs *= BUDGET_STARVED_DECAY;
+        return 0;
     }
+    mSyncSteps += steps;
+    mBudgetLoss = snap.loss;
+    // only the last step is drawn, so only it gets the stats
+    snap.stats = mNN.Stats();
+    // the animation keeps pulsing over whichever step came last
+    ApplySnapshot(std::move(snap));
+    return steps;
 }
 
-void NeuralNetworkActor::DrawBackwardNeurons(size_t totalCols, const std::vector<int>& neuronCounts,
-                                              float colStep, float ox, float oy, float radius) const {
-    if (mLastDeltas.empty()) return;
-    const float animP = 1.0f - mBackwardTimer / ANIMATION_DURATION;
-    const float fCols = static_cast<float>(totalCols);
+float NeuralNetworkActor::AnimProgress(float timer) {
+    const float t = Math::Max(0.0f, timer - gGame.GetAlpha() * Game::FIXED_DT);
+    return 1.0f - t / ANIMATION_DURATION;
+}
 
-    for (int c = 0; c < totalCols; ++c) {
-        // reversed with same -1 offset as forward neurons
-        int rev = static_cast<int>(totalCols) - 1 - c;
-        float phase = animP - static_cast<float>(rev - 1) / fCols;
-        phase *= fCols;
-        float colBrightness = Math::Clamp(phase, 0.0f, 1.0f);
-        float swell = Math::Clamp(1.0f - std::fabs(phase - 1.0f), 0.0f, 1.0f);
-        float colRadius = radius + (radius * 0.5f) * swell;
+void NeuralNetworkActor::ToggleBackgroundTraining() {
+    if (mTrainer.Running()) {
+        // the trained network comes home and the renderer goes back to reading it directly
+        mNN = mTrainer.Stop();
+        mViewLayers.clear();
+        SDL_Log("background training stopped after %llu steps", static_cast<unsigned long long>(mTrainer.Steps()));
+        return;
+    }
+    mIsTraining = false;
+    mBudgetTraining = false;
+    DynamicMatrix inp(1, 1), target(1, 1);
+    TrainingExample(inp, target);
+    // until the first snapshot lands, show the network as it was handed over
+    mNN.RefreshEdges();
+    mViewLayers = mNN.Layers();
+    mLastStats = mNN.Stats();
+    mTrainer.Start(std::move(mNN), std::move(inp), std::move(target), LEARNING_RATE, L1_STRENGTH);
+    mNN = NeuralNetwork();
+    SDL_Log("background training started, visualizing every %zu steps", mTrainer.GetVisualizeEvery());
+    mForwardTimer  = ANIMATION_DURATION;
+    mBackwardTimer = 0.0f;
+}
+
+void NeuralNetworkActor::SetVisualizeEvery(size_t n) {
+    mTrainer.SetVisualizeEvery(n);
+    SDL_Log("visualizing every %zu steps", mTrainer.GetVisualizeEvery());
+}
 
-        int nCount = neuronCounts[c];
+void NeuralNetworkActor::GradMesh::Clear() {
+    batch.Clear();
+    first.clear();
+    count.clear();
+    value.clear();
+}
 
-        // deltas[0] = layer1 delta (column 1), deltas[L-1] = output delta
-        // for column 0 (input), no delta — draw at uniform brightness
-        if (c == 0) {
-            for (int n = 0; n < nCount; ++n) {
-                Vector2 pos = NeuronPos(0, n, nCount, colStep, ox, oy);
-                mDraw->AddFilledCircle(pos.x, pos.y, colRadius, 255, 80, 80,
-                                       static_cast<Uint8>(200.0f * colBrightness));
-            }
-            continue;
+void NeuralNetworkActor::GradMesh::Add(float x1, float y1, float x2, float y2, float thickness, float normalized) {
+    const size_t before = batch.VertexCount();
+    // color is a placeholder, every frame overwrites it
+    batch.AddLine(x1, y1, x2, y2, thickness, {1.0f, 1.0f, 1.0f, 1.0f});
+    first.push_back(before);
+    count.push_back(batch.VertexCount() - before);
+    value.push_back(normalized);
+}
+
+void NeuralNetworkActor::BuildGradMesh(int c, const Layer& layer, GradMesh& mesh) const {
+    mesh.Clear();
+    mesh.layoutGen   = mLayout.Generation();
+    mesh.snapshotGen = mSnapshotGen;
+    mesh.budget      = mEdgeBudget;
+    mesh.built       = true;
+
+    const DynamicMatrix& dW = mLastWeightGrads[c];
+    int inCount  = static_cast<int>(dW.Cols());
+    int outCount = static_cast<int>(dW.Rows());
+    const float ox = mLayout.OriginX(), oy = mLayout.OriginY();
+    const float srcX = ox + static_cast<float>(c) * mLayout.ColStep();
+    const float dstX = srcX + mLayout.ColStep();
+
+    // same LOD as the forward picture
+    int inBins, outBins;
+    EdgeLod::ChooseBins(inCount, outCount, LodHeight(), ViewEdgeBudget(), inBins, outBins);
+    if (inBins != inCount || outBins != outCount) {
+        // folded once per snapshot (and bin counts); a camera move only picks the visible bundles again
+        if (!mesh.bins.Matches(inCount, outCount, inBins, outBins) || mesh.binsGen != mSnapshotGen) {
+            EdgeLod::Aggregate(mesh.bins, inCount, outCount, inBins, outBins,
+                               [&dW](size_t j, size_t i) { return dW.at(j, i); });
+            mesh.binsGen = mSnapshotGen;
+        }
+        const EdgeBins& bins = mesh.bins;
+        if (bins.maxMeanAbs == 0.0f) return;
+        VisibleBundles(c, bins, mViewport, mesh.visible);
+        for (int k : mesh.visible) {
+            const int bo = k / inBins, bi = k % inBins;
+            float srcY, srcSpan, dstY, dstSpan;
+            BinSpan(bi, inBins, inCount, oy, srcY, srcSpan);
+            BinSpan(bo, outBins, outCount, oy, dstY, dstSpan);
+            mesh.Add(srcX, srcY, dstX, dstY, BundleThickness(srcSpan, dstSpan), bins.meanAbs[k] / bins.maxMeanAbs);
         }
+        return;
+    }
+
+    // gradients ride on the same culled edge set the forward picture shows
+    const float maxMag = mLastStats[c].maxAbsGrad;
+    if (maxMag == 0.0f) return;
+    ForEachVisibleEdge(c, layer.edges, mViewport, [&](int j, const EdgeList::Edge& e, const Vector2& src, const Vector2& dst) {
+        mesh.Add(src.x, src.y, dst.x, dst.y, EDGE_THICKNESS, std::fabs(dW.at(static_cast<size_t>(j), e.in)) / maxMag);
+    });
+}
+
+void NeuralNetworkActor::UpdateGradMesh(int c, const Layer& layer, GradMesh& mesh) const {
+    NN_TRACE_SCOPE_ARG("UpdateGradMesh", c);
+    const int totalCols = mLayout.Columns();
+    const float animP = AnimProgress(mBackwardTimer);
+    const float fCols = static_cast<float>(totalCols);
 
-        const DynamicMatrix& delta = mLastDeltas[c - 1];
-        float maxMag = 0.0f;
-        for (int k = 0; k < nCount; ++k)
-            maxMag = std::max(maxMag, std::fabs(delta.at(k, 0)));
-        float alphaScale = (maxMag > 0.0f) ? 1.0f / maxMag : 0.0f;
-
-        for (int n = 0; n < nCount; ++n) {
-            Vector2 pos = NeuronPos(c, n, nCount, colStep, ox, oy);
-            float val = std::fabs(delta.at(n, 0));
-            auto alpha = static_cast<Uint8>(Math::Clamp(val * alphaScale * 255.0f, 0.0f, 255.0f));
-            mDraw->AddFilledCircle(pos.x, pos.y, colRadius, 255, 80, 80,
-                                   static_cast<Uint8>(alpha * colBrightness));
+    // reversed: last weight group (rightmost) fires first
+    int rev = totalCols - 2 - c;
+    float phase = animP - static_cast<float>(rev) / fCols;
+    phase *= fCols;
+    float colBrightness = Math::Clamp(phase, 0.0f, 1.0f);
+    float swell = Math::Clamp(1.0f - std::fabs(phase - 1.0f), 0.0f, 1.0f);
+
+    if (!mesh.built || mesh.layoutGen != mLayout.Generation() || mesh.snapshotGen != mSnapshotGen || mesh.budget != mEdgeBudget)
+        BuildGradMesh(c, layer, mesh);
+    if (mesh.batch.Empty()) return;
+
+    // per frame, only colors: red-orange base, swell toward white, faded in by the pass
+    constexpr float inv = 1.0f / 255.0f;
+    const float g = (80.0f + swell * (255.0f - 80.0f)) * inv;
+    const float b = (50.0f + swell * (255.0f - 50.0f)) * inv;
+    for (size_t k = 0; k < mesh.value.size(); ++k) {
+        if (mesh.count[k] == 0) continue;
+        float baseR = Math::Clamp(mesh.value[k] * 255.0f, 30.0f, 255.0f);
+        mesh.batch.SetColor(mesh.first[k], mesh.count[k], {(baseR + swell * (255.0f - baseR)) * inv, g, b, colBrightness});
+    }
+}
+
+void NeuralNetworkActor::DrawBackwardWeights(const std::vector<Layer>& layers) {
+    NN_TRACE_SCOPE("DrawBackwardWeights");
+    if (mLastWeightGrads.empty()) return;
+    if (mGradMeshes.size() != mLastWeightGrads.size()) mGradMeshes.resize(mLastWeightGrads.size());
+    const auto gaps = static_cast<size_t>(Math::Max(mLayout.Columns() - 1, 0));
+
+    // every layer owns its mesh, so they rebuild/recolor side by side...
+    ForEach(gaps, [&](size_t c) {
+        if (layers[c].kind != LayerKind::Dense) return;
+        UpdateGradMesh(static_cast<int>(c), layers[c], mGradMeshes[c]);
+    });
+    // ...and are queued left to right as before
+    for (size_t c = 0; c < gaps; ++c) {
+        if (layers[c].kind != LayerKind::Dense) continue;
+        mBackDraw->AddBatch(&mGradMeshes[c].batch);
+    }
+}
+
+void NeuralNetworkActor::DrawBackwardNeurons() {
+    NN_TRACE_SCOPE("DrawBackwardNeurons");
+    if (mLastDeltas.empty()) return;
+    ForEach(mTiles.size(), [&](size_t t) { BackwardNeuronTile(mTiles[t], mBackNeuronCmds[t]); });
+    for (size_t t = 0; t < mTiles.size(); ++t) mBackDraw->Append(mBackNeuronCmds[t]);
+}
+
+void NeuralNetworkActor::BackwardNeuronTile(const RenderTile& tile, DrawComponent::Commands& out) const {
+    NN_TRACE_SCOPE_ARG("BackwardNeuronTile", tile.col);
+    out.Clear();
+    const int c = tile.col;
+    const int totalCols = mLayout.Columns();
+    const float radius = mLayout.Radius();
+    const float animP = AnimProgress(mBackwardTimer);
+    const float fCols = static_cast<float>(totalCols);
+
+    // reversed with same -1 offset as forward neurons
+    int rev = totalCols - 1 - c;
+    float phase = animP - static_cast<float>(rev - 1) / fCols;
+    phase *= fCols;
+    float colBrightness = Math::Clamp(phase, 0.0f, 1.0f);
+    float swell = Math::Clamp(1.0f - std::fabs(phase - 1.0f), 0.0f, 1.0f);
+    float colRadius = radius + (radius * 0.5f) * swell;
+
+    // deltas[0] = layer1 delta (column 1), deltas[L-1] = output delta
+    // for column 0 (input), no delta — draw at uniform brightness
+    if (c == 0) {
+        for (int n = tile.first; n < tile.last; ++n) {
+            Vector2 pos = mLayout.Center(0, n);
+            out.AddFilledCircle(pos.x, pos.y, colRadius, 255, 80, 80,
+                                static_cast<Uint8>(200.0f * colBrightness));
         }
+        return;
+    }
+
+    const DynamicMatrix& delta = mLastDeltas[c - 1];
+    const float maxMag = mLastStats[c - 1].maxAbsDelta;
+    float alphaScale = (maxMag > 0.0f) ? 1.0f / maxMag : 0.0f;
+
+    for (int n = tile.first; n < tile.last; ++n) {
+        Vector2 pos = mLayout.Center(c, n);
+        float val = std::fabs(delta.at(n, 0));
+        auto alpha = static_cast<Uint8>(Math::Clamp(val * alphaScale * 255.0f, 0.0f, 255.0f));
+        out.AddFilledCircle(pos.x, pos.y, colRadius, 255, 80, 80,
+                            static_cast<Uint8>(alpha * colBrightness));
     }
 }
 
 void NeuralNetworkActor::HandleRender()
 {
-    const auto& layers = mNN.Layers();
+    NN_TRACE_SCOPE("NeuralNetworkActor::HandleRender");
+    // steps taken on this thread leave the edge lists stale; the trainer cuts its own before publishing
+    if (!mTrainer.Running()) mNN.RefreshEdges();
+    const auto& layers = ViewLayers();
     if (layers.empty()) return;
 
-    // get actual rectangle origin coordinates
-    const Vector2& center = GetTransform().GetPosition();
-    const float ox = center.x - mWidth  / 2.0f;
-    const float oy = center.y - mHeight / 2.0f;
-
-    // +1 for input column (which is not actually a Layer, but which we do render)
-    const int totalCols = static_cast<int>(layers.size()) + 1;
-    // -1 because we have N columns so N-1 gaps
-    const float colStep = mWidth / static_cast<float>(totalCols - 1);
-
-    // neuron counts for each column
-    std::vector<int> neuronCounts(totalCols);
-    neuronCounts[0] = static_cast<int>(layers[0].weights.Cols());
-    for (int c = 1; c < totalCols; ++c) {
-        neuronCounts[c] = static_cast<int>(layers[c - 1].weights.Rows());
-    }
-
-    // radius is determined by the smallest row gap
-    int maxNeurons = *std::max_element(neuronCounts.begin(), neuronCounts.end());
-    float minRowStep = mHeight / static_cast<float>(maxNeurons + 1);
-    float radius = NeuronRadius(colStep, minRowStep);
+    // the camera scales and moves the rectangle; the layout only recomputes when it or the topology change.
+    // baked layer pictures don't follow it: they key on what they show of their gaps (see DrawWeights)
+    const Vector2 center = GetTransform().GetPosition() + mPan;
+    const float w = mWidth * mZoom, h = mHeight * mZoom;
+    mLayout.Update(center.x - w / 2.0f, center.y - h / 2.0f, w, h, layers);
+    UpdateTiles();
 
-    DrawWeights(totalCols, layers, colStep, ox, oy);
-    DrawNeurons(totalCols, layers, neuronCounts, colStep, ox, oy, radius);
+    // weights are baked through the renderer, so they stay on this thread (and out of the timing)
+    DrawWeights(layers);
+    mRebakes = mWeightCache.TakeRedrawCount();
 
+    const Uint64 start = SDL_GetPerformanceCounter();
+    DrawNeurons(layers);
     if (mBackwardTimer > 0.0f) {
-        DrawBackwardWeights(totalCols, colStep, ox, oy);
-        DrawBackwardNeurons(totalCols, neuronCounts, colStep, ox, oy, radius);
+        DrawBackwardWeights(layers);
+        DrawBackwardNeurons();
     }
+    const float ms = static_cast<float>(SDL_GetPerformanceCounter() - start) * Game::MS_PER_SEC
+                   / static_cast<float>(SDL_GetPerformanceFrequency());
+    float& avg = mBuildMs[mParallelRender ? 1 : 0];
+    avg = avg == 0.0f ? ms : avg + (ms - avg) * 0.05f;
 }
 
 void NeuralNetworkActor::HandleUpdate(float deltaTime) {
     Actor::HandleUpdate(deltaTime);
+    // a running timer moves something, including the step that brings it to rest
+    if (mForwardTimer > 0.0f || mBackwardTimer > 0.0f) MarkDirty();
+    // held keys move the camera at a steady rate however the frames fall
+    if (mPanHeld.x != 0.0f || mPanHeld.y != 0.0f) Pan(mPanHeld * (-PAN_PIXELS_PER_SEC * deltaTime));
+    if (mZoomHeld != 0.0f)
+        ZoomAt(std::exp(mZoomHeld * KEY_ZOOM_PER_SEC * deltaTime),
+               {mViewport.x + mViewport.w / 2.0f, mViewport.y + mViewport.h / 2.0f});
+
+    if (mTrainer.Running()) {
+        mTrainer.Poll();
+        // whatever the trainer published most recently; older ones were skipped, never queued
+        if (TrainSnapshot* snap = mTrainer.TakeLatest()) {
+            // swapped, like the stats in ApplySnapshot: the slot keeps a network-shaped copy to publish into next
+            mViewLayers.swap(snap->layers);
+            mBackgroundLoss = snap->loss;
+            ApplySnapshot(std::move(*snap));
+        }
+    }
 
     if (mForwardTimer > 0.0f) {
         mForwardTimer -= deltaTime;
         if (mForwardTimer <= 0.0f) {
             mForwardTimer = 0.0f;
             // forward finished — start backward if training
-            if (mIsTraining) mBackwardTimer = ANIMATION_DURATION;
+            if (mIsTraining || mTrainer.Running() || mBudgetTraining) mBackwardTimer = ANIMATION_DURATION;
         }
     } else if (mBackwardTimer > 0.0f) {
         mBackwardTimer -= deltaTime;
@@ -342,12 +794,101 @@ void NeuralNetworkActor::HandleUpdate(float deltaTime) {
             mBackwardTimer = 0.0f;
             // backward finished — kick off next training step
             if (mIsTraining) StartGraphicTrain();
+            // background and budgeted training don't wait on the animation, it just keeps pulsing over the latest snapshot
+            if (mTrainer.Running() || mBudgetTraining) {
+                SDL_Log("step %llu  loss: %.4f", static_cast<unsigned long long>(TrainingSteps()),
+                        mTrainer.Running() ? mBackgroundLoss : mBudgetLoss);
+                mForwardTimer = ANIMATION_DURATION;
+            }
         }
     }
 }
 
 void NeuralNetworkActor::HandleInput(const bool keys[], SDL_MouseButtonFlags mouseButtons, const Vector2 &posMouse) {
     Actor::HandleInput(keys, mouseButtons, posMouse);
-    Game::LeadingEdge(keys[SDL_SCANCODE_R], mLastR, mRFunc);
-    Game::LeadingEdge(keys[SDL_SCANCODE_T], mLastT, mTFunc);
+    // R and T step mNN on this thread, which the trainer owns while it runs
+    Game::LeadingEdge(keys[SDL_SCANCODE_R], mLastR, mRFunc, !mTrainer.Running());
+    Game::LeadingEdge(keys[SDL_SCANCODE_T], mLastT, mTFunc, !mTrainer.Running());
+    // F trains here too, as many steps a frame as its spare time allows
+    Game::LeadingEdge(keys[SDL_SCANCODE_F], mLastF, mFFunc, !mTrainer.Running());
+    Game::LeadingEdge(keys[SDL_SCANCODE_B], mLastB, mBFunc);
+    // -/= halve/double how often the background trainer publishes a snapshot
+    Game::LeadingEdge(keys[SDL_SCANCODE_MINUS], mLastMinus, mMinusFunc);
+    Game::LeadingEdge(keys[SDL_SCANCODE_EQUALS], mLastEquals, mEqualsFunc);
+    // P flips between parallel and serial command building and logs how long each has been taking
+    Game::LeadingEdge(keys[SDL_SCANCODE_P], mLastP, mPFunc);
+    // [/] halve/double how many edge bundles a layer may draw before its neurons get binned
+    Game::LeadingEdge(keys[SDL_SCANCODE_LEFTBRACKET], mLastLeftBracket, mLeftBracketFunc);
+    Game::LeadingEdge(keys[SDL_SCANCODE_RIGHTBRACKET], mLastRightBracket, mRightBracketFunc);
+
+    // camera: Home fits the network again...
+    Game::LeadingEdge(keys[SDL_SCANCODE_HOME], mLastHome, mHomeFunc);
+    // ...arrows and PageUp/PageDown are held, so they only set which way HandleUpdate moves
+    mPanHeld = {static_cast<float>(keys[SDL_SCANCODE_RIGHT]) - static_cast<float>(keys[SDL_SCANCODE_LEFT]),
+                static_cast<float>(keys[SDL_SCANCODE_DOWN]) - static_cast<float>(keys[SDL_SCANCODE_UP])};
+    mZoomHeld = static_cast<float>(keys[SDL_SCANCODE_PAGEUP]) - static_cast<float>(keys[SDL_SCANCODE_PAGEDOWN]);
+    // the wheel zooms about the cursor
+    if (const float wheel = gGame.GetMouseWheel(); wheel != 0.0f && InView(posMouse))
+        ZoomAt(std::pow(WHEEL_ZOOM, wheel), posMouse);
+    // a left drag that starts in the viewport carries the network with it
+    if ((mouseButtons & SDL_BUTTON_LMASK) && (mDragging || InView(posMouse))) {
+        if (mDragging) Pan(posMouse - mDragFrom);
+        mDragging = true;
+        mDragFrom = posMouse;
+    } else {
+        mDragging = false;
+    }
+}
+
+void NeuralNetworkActor::SetViewport(const SDL_FRect& view) {
+    mViewport = view;
+    MarkDirty();
+    // zoomed in, the network runs past the viewport; the clip keeps it off the sidebar
+    const SDL_Rect clip = {static_cast<int>(std::floor(view.x)), static_cast<int>(std::floor(view.y)),
+                           static_cast<int>(std::ceil(view.w)), static_cast<int>(std::ceil(view.h))};
+    mDraw->SetClipRect(&clip);
+    mBackDraw->SetClipRect(&clip);
+    MoveCamera(mPan);
+}
+
+bool NeuralNetworkActor::InView(const Vector2& screen) const {
+    return screen.x >= mViewport.x && screen.x < mViewport.x + mViewport.w
+        && screen.y >= mViewport.y && screen.y < mViewport.y + mViewport.h;
+}
+
+void NeuralNetworkActor::ZoomAt(float factor, const Vector2& screen) {
+    const float zoom = Math::Clamp(mZoom * factor, MIN_ZOOM, MAX_ZOOM);
+    if (zoom == mZoom) return;
+    // the point under `screen` stays there, so the center moves away from (or toward) it by the same ratio
+    const Vector2& rest = GetTransform().GetPosition();
+    const Vector2 center = rest + mPan;
+    const Vector2 moved = screen + (center - screen) * (zoom / mZoom);
+    mZoom = zoom;
+    MarkDirty();
+    MoveCamera(moved - rest);
+}
+
+void NeuralNetworkActor::Pan(const Vector2& delta) {
+    if (delta.x == 0.0f && delta.y == 0.0f) return;
+    MoveCamera(mPan + delta);
+}
+
+void NeuralNetworkActor::ResetCamera() {
+    mZoom = 1.0f;
+    mPan = {};
+    MarkDirty();
+}
+
+void NeuralNetworkActor::MoveCamera(const Vector2& pan) {
+    // the box keeps MIN_VISIBLE_PIXELS (or half of itself, if it's smaller than that) inside the viewport
+    const Vector2& rest = GetTransform().GetPosition();
+    const float hw = mWidth * mZoom / 2.0f, hh = mHeight * mZoom / 2.0f;
+    const float kx = Math::Min(hw, MIN_VISIBLE_PIXELS), ky = Math::Min(hh, MIN_VISIBLE_PIXELS);
+    const Vector2 center = rest + pan;
+    const Vector2 clamped = {Math::Clamp(center.x, mViewport.x + kx - hw, mViewport.x + mViewport.w - kx + hw),
+                             Math::Clamp(center.y, mViewport.y + ky - hh, mViewport.y + mViewport.h - ky + hh)};
+    const Vector2 next = clamped - rest;
+    if (next.x == mPan.x && next.y == mPan.y) return;
+    mPan = next;
+    MarkDirty();
 }
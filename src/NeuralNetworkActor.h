@@ -6,19 +6,78 @@
 #define NEURAL_NETWORK_ACTOR_H
 
 #include "Actor.h"
+#include "DrawComponent.h"
+#include "EdgeLod.h"
+#include "GeometryBatch.h"
+#include "NetworkLayout.h"
 #include "NeuralNetwork.h"
+#include "RenderTargetCache.h"
+#include "Trainer.h"
 
-class DrawComponent;
-
-class NeuralNetworkActor : public Actor {
+class NeuralNetworkActor final : public Actor {
     static constexpr float ANIMATION_DURATION = 1.0f;
+    static constexpr float LEARNING_RATE = 0.075f;
+    static constexpr float L1_STRENGTH = 0.005f;
+    // camera: 1 fits the network in its box
+    static constexpr float MIN_ZOOM = 0.5f;
+    static constexpr float MAX_ZOOM = 256.0f;
+    static constexpr float WHEEL_ZOOM = 1.2f;         // per notch
+    static constexpr float KEY_ZOOM_PER_SEC = 1.5f;   // e^this per second held
+    static constexpr float PAN_PIXELS_PER_SEC = 600.0f;
+    static constexpr float MIN_VISIBLE_PIXELS = 32.0f;  // of the network kept in view however far it's panned
+    // below these (swollen radius, label height) a neuron or its label doesn't cover enough pixels to be worth a quad
+    static constexpr float MIN_NEURON_PIXELS = 0.25f;
+    static constexpr float MIN_LABEL_PIXELS = 4.0f;
+    static constexpr float EDGE_THICKNESS = 2.0f;
+    static constexpr float MAX_BUNDLE_THICKNESS = 12.0f;
+    // zoomed in, the edge budget grows with the zoom up to this factor (see ViewEdgeBudget)
+    static constexpr size_t MAX_BUDGET_ZOOM = 16;
 public:
+    // most edge bundles drawn per layer before neurons get binned (see EdgeLod)
+    static constexpr size_t DEFAULT_EDGE_BUDGET = 4096;
+    // [ and ] halve/double it within these
+    static constexpr size_t MIN_EDGE_BUDGET = 64;
+    static constexpr size_t MAX_EDGE_BUDGET = size_t{1} << 20;
+
     NeuralNetworkActor();
     NeuralNetwork& GetNN() {return mNN;}
     void SetWidth(float w){mWidth = w;}
     void SetHeight(float h){mHeight = h;}
+    // the screen area the camera looks through: nothing outside it is built, and drawing is clipped to it
+    void SetViewport(const SDL_FRect& view);
+    // scale by factor about a screen point (which stays put), move by screen pixels, or fit the box again (Home).
+    // wheel/PageUp/PageDown zoom, dragging with the left button or the arrow keys pan
+    void ZoomAt(float factor, const Vector2& screen);
+    void Pan(const Vector2& delta);
+    void ResetCamera();
+    [[nodiscard]] float GetZoom() const {return mZoom;}
     void StartGraphicForward();
     void StartGraphicTrain();
+    // train one step at a time on this thread, animating each (T)
+    void SetTraining(bool training);
+    // train on this thread in whatever each frame leaves of its budget, pulsing over the latest step (F).
+    // a network whose single step doesn't fit the spare time only retries now and then, each time overrunning
+    // its frame; B is for those
+    void SetBudgetedTraining(bool on);
+    [[nodiscard]] bool GetBudgetedTraining() const {return mBudgetTraining;}
+    // steps while the next one is expected to finish within budgetMs; returns how many ran
+    size_t TrainFor(float budgetMs);
+    // hand the network to a Trainer thread that steps it nonstop, or take it back
+    void ToggleBackgroundTraining();
+    // background training publishes (and so visualizes) one step in n
+    void SetVisualizeEvery(size_t n);
+    // 0 = no budget, only pixel density limits detail
+    void SetEdgeBudget(size_t budget);
+    [[nodiscard]] size_t GetEdgeBudget() const {return mEdgeBudget;}
+    // steps taken by whichever trainer is active (the background count restarts with it), and how long the last took
+    [[nodiscard]] uint64_t TrainingSteps() const {return mTrainer.Running() ? mTrainer.Steps() : mSyncSteps;}
+    [[nodiscard]] float LastStepMs() const {return mTrainer.Running() ? mTrainer.LastStepMs() : mSyncStepMs;}
+    // layer pictures the last drawn frame had to rebake (0 while weights and camera hold still)
+    [[nodiscard]] size_t LastRebakes() const {return mRebakes;}
+    // build neuron and gradient draw commands on the thread pool (per tile / per layer) or all on this thread.
+    // either way the commands are merged in the same order, so the frame is identical
+    void SetParallelRender(bool parallel);
+    [[nodiscard]] bool GetParallelRender() const {return mParallelRender;}
 
 protected:
     void HandleRender() override;
@@ -27,38 +86,185 @@ protected:
 
 private:
     NeuralNetwork  mNN;
+    // background training: owns the network while running; the renderer reads mViewLayers,
+    // the copy that came with the latest snapshot, instead
+    Trainer            mTrainer;
+    std::vector<Layer> mViewLayers;
+    float              mBackgroundLoss = 0.0f;
+    [[nodiscard]] const std::vector<Layer>& ViewLayers() const {
+        return mTrainer.Running() ? mViewLayers : mNN.Layers();
+    }
+    // training's per-layer stats for those same layers (the snapshot's, while the trainer runs)
+    [[nodiscard]] const std::vector<LayerStats>& ViewStats() const {
+        return mTrainer.Running() ? mLastStats : mNN.Stats();
+    }
     float          mWidth;
     float          mHeight;
+    SDL_FRect      mViewport{};
+    float          mZoom = 1.0f;
+    Vector2        mPan;             // of the network's center from where the transform puts it, in pixels
+    Vector2        mPanHeld;         // arrow keys held, -1..1 per axis, applied per step in HandleUpdate
+    float          mZoomHeld = 0.0f; // PageUp/PageDown the same way
+    bool           mDragging = false;
+    Vector2        mDragFrom;
+    void MoveCamera(const Vector2& pan);  // clamped so the network can't leave the viewport entirely
+    [[nodiscard]] bool InView(const Vector2& screen) const;
     DrawComponent* mDraw = nullptr;
+    // backward overlay gets its own component (drawn after mDraw) so its lines land on top of
+    // the forward neurons — each component draws all its lines before all its circles
+    DrawComponent* mBackDraw = nullptr;
+
+    // one render target per Dense layer holding its static edge picture
+    RenderTargetCache mWeightCache;
+    GeometryBatch     mEdgeBatch;  // scratch for baking a layer
+    // each Dense layer's bundles, kept while its weights and bin counts are, since panning rebakes only the visible part
+    struct LayerBins {
+        EdgeBins bins;
+        uint64_t version = 0;
+    };
+    std::vector<LayerBins> mLayerBins;
+    // what each layer's texture was last baked for. the picture only changes with these, so panning a layer
+    // that's wholly in view just moves its texture
+    struct BakeKey {
+        uint64_t version = 0;            // the layer's weights
+        float    x = 0.0f, y = 0.0f;     // its input column's x and the layout's top, in the texture
+        float    colStep = 0.0f, height = 0.0f;
+        uint64_t stamp = 0;              // ticks when any of the above change; the cache's version for the slot
+    };
+    std::vector<BakeKey> mBakeKeys;
+    std::vector<int>     mVisibleBundles;  // scratch for BakeWeights
+    size_t            mEdgeBudget = DEFAULT_EDGE_BUDGET;
+    size_t            mRebakes = 0;
+    // neuron centers, rebuilt only when the box (so the camera) or the topology changes
+    NetworkLayout     mLayout;
+
+    // neurons are drawn in tiles of up to this many from one column, each tile its own task
+    static constexpr int NEURONS_PER_TILE = 256;
+    struct RenderTile {
+        int col, first, last;  // neurons [first, last) of column col
+    };
+    std::vector<RenderTile>             mTiles;           // column-major, i.e. serial draw order. only what's in view
+    uint64_t                            mTilesGen = 0;    // layout generation the tiles were cut for...
+    SDL_FRect                           mTilesView{};     // ...and the viewport
+    std::vector<DrawComponent::Commands> mNeuronCmds;     // one per tile, merged in tile order
+    std::vector<DrawComponent::Commands> mBackNeuronCmds;
+    std::vector<GlyphAtlas::Label>      mColumnLabels;    // interned up front, the table isn't thread-safe
+    bool  mParallelRender = true;
+    // smoothed ms to build a frame's neuron/gradient commands, [0] serial, [1] parallel
+    float mBuildMs[2] = {0.0f, 0.0f};
+    void UpdateTiles();
+    // fn(i) for i in [0, count): on the pool when rendering in parallel, else in order right here
+    void ForEach(size_t count, const std::function<void(size_t)>& fn) const;
+
+    // backward overlay edges for one layer: positions are built once per snapshot (or layout change),
+    // after that each frame only rewrites vertex colors and hands the same batch to mBackDraw
+    struct GradMesh {
+        GeometryBatch       batch;
+        std::vector<size_t> first;  // first vertex of each segment
+        std::vector<size_t> count;  // its vertex count (0 if it was too short to draw)
+        std::vector<float>  value;  // |dW| of the segment, normalized to the layer's max
+        uint64_t layoutGen = 0, snapshotGen = 0;
+        size_t   budget = 0;
+        bool     built = false;
+        // dW folded into bundles, kept for as long as the snapshot and bin counts are
+        EdgeBins         bins;
+        uint64_t         binsGen = 0;
+        std::vector<int> visible;  // bundles crossing the view
+        void Clear();
+        void Add(float x1, float y1, float x2, float y2, float thickness, float normalized);
+    };
+    std::vector<GradMesh> mGradMeshes;
+    uint64_t              mSnapshotGen = 0;  // ticks whenever new gradients arrive
 
     float mForwardTimer  = 0.0f;
     float mBackwardTimer = 0.0f;
     bool  mIsTraining    = false;
+    bool  mBudgetTraining = false;
+    float mBudgetStepMs  = 0.0f;  // expected cost of one step, for fitting steps into the budget
+    // each frame that can't fit a step shrinks the estimate by this, so one slow step can't lock training out
+    static constexpr float BUDGET_STARVED_DECAY = 0.9f;
+    float mBudgetLoss    = 0.0f;
+    // steps taken right here with T, for the HUD
+    uint64_t mSyncSteps  = 0;
+    float    mSyncStepMs = 0.0f;
 
     std::vector<DynamicMatrix> mLastActivation;  // a at each column, size = totalCols
     std::vector<DynamicMatrix> mLastDeltas;       // δ at each layer, size = L (col 1..L)
     std::vector<DynamicMatrix> mLastWeightGrads;  // dW per layer, size = L
+    std::vector<LayerStats>    mLastStats;        // training's per-layer maxima for the above, size = L
+    std::vector<float>         mLastColumnMax;    // max |a| per column, from mLastStats or one scan of a forward pass
 
     bool mLastR = false;
     std::function<void()> mRFunc = [this] { StartGraphicForward(); };
     bool mLastT = false;
-    std::function<void()> mTFunc = [this] {
-        mIsTraining = !mIsTraining;
-        if (mIsTraining) StartGraphicTrain();
+    std::function<void()> mTFunc = [this] { SetTraining(!mIsTraining); };
+    bool mLastB = false;
+    std::function<void()> mBFunc = [this] { ToggleBackgroundTraining(); };
+    bool mLastMinus = false;
+    std::function<void()> mMinusFunc = [this] { SetVisualizeEvery(mTrainer.GetVisualizeEvery() / 2); };
+    bool mLastEquals = false;
+    std::function<void()> mEqualsFunc = [this] { SetVisualizeEvery(mTrainer.GetVisualizeEvery() * 2); };
+    bool mLastP = false;
+    std::function<void()> mPFunc = [this] { SetParallelRender(!mParallelRender); };
+    bool mLastF = false;
+    std::function<void()> mFFunc = [this] { SetBudgetedTraining(!mBudgetTraining); };
+    bool mLastLeftBracket = false;
+    std::function<void()> mLeftBracketFunc = [this] {
+        SetEdgeBudget(mEdgeBudget > MIN_EDGE_BUDGET ? mEdgeBudget / 2 : mEdgeBudget);
     };
+    bool mLastRightBracket = false;
+    std::function<void()> mRightBracketFunc = [this] {
+        SetEdgeBudget(mEdgeBudget < MAX_EDGE_BUDGET ? mEdgeBudget * 2 : mEdgeBudget);
+    };
+    bool mLastHome = false;
+    std::function<void()> mHomeFunc = [this] { ResetCamera(); };
+
+    // 0 -> 1 through an animation whose timer is `timer`, extrapolated to where this frame falls between fixed steps
+    [[nodiscard]] static float AnimProgress(float timer);
 
-    [[nodiscard]] Vector2 NeuronPos(int col, int neuronIdx, int neuronCount,
-                      float colStep, float originX, float originY) const;
-    static float NeuronRadius(float colStep, float minRowStep);
+    // center y and pixel height of an LOD bin of neurons in a column of `count`
+    void BinSpan(int bin, int bins, int count, float originY, float& centerY, float& spanPx) const;
+    static float BundleThickness(float srcSpan, float dstSpan);
+    // whether a line from x1 to x2 (x1 < x2), thickness wide, crosses view
+    static bool CrossesView(float x1, float y1, float x2, float y2, float thickness, const SDL_FRect& view);
+    // for lines from x1 to x2 with one end's y fixed (the end at x2 if fixedAtDst, else at x1): the range
+    // [lo, hi] of the other end's y over which they cross view. false if no y does
+    static bool CrossingSpan(float x1, float x2, float fixedY, bool fixedAtDst, float thickness, const SDL_FRect& view,
+                             float& lo, float& hi);
+    // bins [first, last) of a column whose centers may lie in [top, bottom], so a superset of those that do
+    void VisibleBins(int col, int bins, float top, float bottom, int& first, int& last) const;
+    // layer c's bundles that cross view, weakest first. only the bins that can are looked at
+    void VisibleBundles(int c, const EdgeBins& bins, const SDL_FRect& view, std::vector<int>& out) const;
+    // f(j, edge, src, dst) for layer c's listed edges that cross view, in screen coordinates, row by row
+    template<typename F>
+    void ForEachVisibleEdge(int c, const EdgeList& edges, const SDL_FRect& view, F f) const;
+    // the zoom rounded down to a power of two: bins only change when it crosses one, not on every wheel notch
+    [[nodiscard]] float ZoomStep() const;
+    // the edge budget is for what's on screen: zoomed in z times, roughly 1/z of a layer's bundles cross the viewport
+    [[nodiscard]] size_t ViewEdgeBudget() const;
+    // the column height bins are chosen for, at ZoomStep rather than the exact zoom
+    [[nodiscard]] float LodHeight() const { return mHeight * ZoomStep(); }
     void SetNN(NeuralNetwork nn);
+    // the fixed input/target pair the visualizer trains on
+    void TrainingExample(DynamicMatrix& input, DynamicMatrix& target) const;
+    // take a step's activations/deltas/gradients/stats for drawing
+    void ApplySnapshot(TrainSnapshot&& snap);
 
     // forward pass draws (left → right, uses mForwardTimer)
-    void DrawWeights(size_t totalCols, const std::vector<Layer>& layers, float colStep, float ox, float oy) const;
-    void DrawNeurons(size_t totalCols, const std::vector<Layer>& layers, const std::vector<int>& neuronCounts, float colStep, float ox, float oy, float radius);
+    // weights are a cached texture per layer plus a per-frame fade/swell; the texture is rebaked only when stale
+    void DrawWeights(const std::vector<Layer>& layers);
+    // layer c's edges that cross `area`, the part of the screen the texture covers
+    void BakeWeights(SDL_Renderer* renderer, int c, const Layer& W, float maxAbsWeight, const SDL_FRect& area);
+    void DrawNeurons(const std::vector<Layer>& layers);
+    void NeuronTile(const RenderTile& tile, const std::vector<Layer>& layers, DrawComponent::Commands& out) const;
 
     // backward pass draws (right → left, uses mBackwardTimer)
-    void DrawBackwardWeights(size_t totalCols, float colStep, float ox, float oy) const;
-    void DrawBackwardNeurons(size_t totalCols, const std::vector<int>& neuronCounts, float colStep, float ox, float oy, float radius) const;
+    void DrawBackwardWeights(const std::vector<Layer>& layers);
+    void BuildGradMesh(int c, const Layer& layer, GradMesh& mesh) const;
+    // rebuild if stale, then recolor for this frame of the pass
+    void UpdateGradMesh(int c, const Layer& layer, GradMesh& mesh) const;
+    void DrawBackwardNeurons();
+    void BackwardNeuronTile(const RenderTile& tile, DrawComponent::Commands& out) const;
 };
 
 #endif // NEURAL_NETWORK_ACTOR_H
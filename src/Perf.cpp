@@ -0,0 +1,281 @@
+//
+// Created by Ben Meyers on 3/22/26.
+//
+
+#include "Perf.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include "DynamicMatrix.h"
+#include "SDL3/SDL.h"
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#elif !defined(__EMSCRIPTEN__)
+#include <sys/resource.h>
+#endif
+
+namespace {
+    uint32_t gDrawCalls = 0;
+    uint64_t gVertices  = 0;
+
+    float MsSince(uint64_t start, uint64_t now) {
+        return static_cast<float>(now - start) * 1000.0f / static_cast<float>(SDL_GetPerformanceFrequency());
+    }
+
+    std::atomic<uint64_t> gAllocations{0}, gFrees{0}, gBytes{0};
+    std::atomic<uint64_t> gLiveBytes{0}, gPeakLiveBytes{0};
+    // trivially constructed/destroyed, so safe to touch from operator new at any point in a thread's life
+    struct ThreadCounters { uint64_t allocations, frees, bytes; };
+    thread_local ThreadCounters tCounters{0, 0, 0};
+
+    // written by whichever thread runs the phase (the trainer steps hundreds of thousands of times a
+    // second), so plain relaxed atomics; a reader may see `last` mid-update, which is fine for a report
+    struct AtomicCounters {
+        std::atomic<uint64_t> allocations{0}, frees{0}, bytes{0}, matrixBuffers{0}, matrixBytes{0};
+        void Add(const Perf::AllocCounters& c) {
+            allocations.fetch_add(c.allocations, std::memory_order_relaxed);
+            frees.fetch_add(c.frees, std::memory_order_relaxed);
+            bytes.fetch_add(c.bytes, std::memory_order_relaxed);
+            matrixBuffers.fetch_add(c.matrixBuffers, std::memory_order_relaxed);
+            matrixBytes.fetch_add(c.matrixBytes, std::memory_order_relaxed);
+        }
+        void Set(const Perf::AllocCounters& c) {
+            allocations.store(c.allocations, std::memory_order_relaxed);
+            frees.store(c.frees, std::memory_order_relaxed);
+            bytes.store(c.bytes, std::memory_order_relaxed);
+            matrixBuffers.store(c.matrixBuffers, std::memory_order_relaxed);
+            matrixBytes.store(c.matrixBytes, std::memory_order_relaxed);
+        }
+        [[nodiscard]] Perf::AllocCounters Get() const {
+            return {allocations.load(std::memory_order_relaxed), frees.load(std::memory_order_relaxed),
+                    bytes.load(std::memory_order_relaxed), matrixBuffers.load(std::memory_order_relaxed),
+                    matrixBytes.load(std::memory_order_relaxed)};
+        }
+    };
+    struct PhaseCounters {
+        std::atomic<uint64_t> calls{0};
+        AtomicCounters total, last;
+        std::atomic<uint64_t> peakRss{0};
+    };
+    std::array<PhaseCounters, Perf::ALLOC_PHASE_COUNT> gPhases;
+    // asking the OS for RSS is a syscall, too slow to pay on every train step
+    constexpr uint64_t RSS_SAMPLE_EVERY = 256;
+
+#if NN_ALLOC_TRACKING
+    // each block carries its size in front so delete knows how much went away
+    constexpr std::size_t HEADER = alignof(std::max_align_t);
+    static_assert(HEADER >= sizeof(std::size_t));
+
+    void* CountedAlloc(std::size_t size) {
+        auto* base = static_cast<unsigned char*>(std::malloc(size + HEADER));
+        if (!base) return nullptr;
+        *reinterpret_cast<std::size_t*>(base) = size;
+        gAllocations.fetch_add(1, std::memory_order_relaxed);
+        gBytes.fetch_add(size, std::memory_order_relaxed);
+        const uint64_t live = gLiveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+        uint64_t peak = gPeakLiveBytes.load(std::memory_order_relaxed);
+        while (live > peak && !gPeakLiveBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+        ++tCounters.allocations;
+        tCounters.bytes += size;
+        return base + HEADER;
+    }
+
+    void CountedFree(void* p) {
+        if (!p) return;
+        unsigned char* base = static_cast<unsigned char*>(p) - HEADER;
+        gFrees.fetch_add(1, std::memory_order_relaxed);
+        gLiveBytes.fetch_sub(*reinterpret_cast<std::size_t*>(base), std::memory_order_relaxed);
+        ++tCounters.frees;
+        std::free(base);
+    }
+#endif
+
+    Perf::AllocCounters WithMatrices(Perf::AllocCounters c, const DynamicMatrix::StorageCounters& m) {
+        c.matrixBuffers = m.buffers;
+        c.matrixBytes   = m.bytes;
+        return c;
+    }
+}
+
+#if NN_ALLOC_TRACKING
+// every plain new/new[] in the program comes through here. over-aligned allocations keep the
+// library's own (uncounted) versions, which pair with its own aligned deletes
+void* operator new(std::size_t size) {
+    if (void* p = CountedAlloc(size)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) {
+    if (void* p = CountedAlloc(size)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return CountedAlloc(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return CountedAlloc(size); }
+void operator delete(void* p) noexcept { CountedFree(p); }
+void operator delete[](void* p) noexcept { CountedFree(p); }
+void operator delete(void* p, std::size_t) noexcept { CountedFree(p); }
+void operator delete[](void* p, std::size_t) noexcept { CountedFree(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { CountedFree(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { CountedFree(p); }
+#endif
+
+Perf::AllocCounters Perf::ProcessAllocs() {
+    return WithMatrices({gAllocations.load(std::memory_order_relaxed), gFrees.load(std::memory_order_relaxed),
+                         gBytes.load(std::memory_order_relaxed)}, DynamicMatrix::Storage());
+}
+
+Perf::AllocCounters Perf::ThreadAllocs() {
+    return WithMatrices({tCounters.allocations, tCounters.frees, tCounters.bytes}, DynamicMatrix::ThreadStorage());
+}
+
+uint64_t Perf::LiveBytes() {
+    return gLiveBytes.load(std::memory_order_relaxed);
+}
+
+uint64_t Perf::PeakLiveBytes() {
+    return gPeakLiveBytes.load(std::memory_order_relaxed);
+}
+
+uint64_t Perf::PeakRssBytes() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (K32GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) return pmc.PeakWorkingSetSize;
+    return 0;
+#elif defined(__EMSCRIPTEN__)
+    return 0;
+#else
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#if defined(__APPLE__)
+    return static_cast<uint64_t>(usage.ru_maxrss);         // bytes
+#else
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024u; // kilobytes
+#endif
+#endif
+}
+
+const char* Perf::AllocPhaseName(AllocPhase phase) {
+    switch (phase) {
+        case TRAIN_STEP: return "train step";
+        case FORWARD:    return "forward";
+        case RENDER:     return "render";
+        default:         return "?";
+    }
+}
+
+Perf::PhaseAllocs Perf::PhaseStats(AllocPhase phase) {
+    const PhaseCounters& p = gPhases[phase];
+    PhaseAllocs out;
+    out.calls   = p.calls.load(std::memory_order_relaxed);
+    out.total   = p.total.Get();
+    out.last    = p.last.Get();
+    out.peakRss = p.peakRss.load(std::memory_order_relaxed);
+    return out;
+}
+
+Perf::PhaseScope::~PhaseScope() {
+    const AllocCounters delta = mProbe.Delta();
+    PhaseCounters& p = gPhases[mPhase];
+    p.total.Add(delta);
+    p.last.Set(delta);
+    if (p.calls.fetch_add(1, std::memory_order_relaxed) % RSS_SAMPLE_EVERY == 0)
+        p.peakRss.store(PeakRssBytes(), std::memory_order_relaxed);
+}
+
+std::string Perf::AllocReport() {
+    constexpr double MB = 1024.0 * 1024.0;
+    std::string out;
+    char line[192];
+    const AllocCounters c = ProcessAllocs();
+#if !NN_ALLOC_TRACKING
+    out += "heap tracking compiled out (NN_ALLOC_TRACKING=0), heap counters read zero\n";
+#endif
+    std::snprintf(line, sizeof(line), "process: %llu allocs, %llu frees, %.2f MB requested, %llu matrix buffers (%.2f MB)\n",
+                  static_cast<unsigned long long>(c.allocations), static_cast<unsigned long long>(c.frees), c.bytes / MB,
+                  static_cast<unsigned long long>(c.matrixBuffers), c.matrixBytes / MB);
+    out += line;
+    std::snprintf(line, sizeof(line), "live %.2f MB, peak live %.2f MB, peak RSS %.2f MB\n",
+                  LiveBytes() / MB, PeakLiveBytes() / MB, PeakRssBytes() / MB);
+    out += line;
+    for (int i = 0; i < ALLOC_PHASE_COUNT; ++i) {
+        const auto phase = static_cast<AllocPhase>(i);
+        const PhaseAllocs p = PhaseStats(phase);
+        if (p.calls == 0) continue;
+        const double n = static_cast<double>(p.calls);
+        std::snprintf(line, sizeof(line),
+                      "%-10s x%-8llu per call: %.1f allocs, %.0f B, %.1f matrix buffers | last: %llu allocs, %llu B | peak RSS %.2f MB\n",
+                      AllocPhaseName(phase), static_cast<unsigned long long>(p.calls),
+                      p.total.allocations / n, p.total.bytes / n, p.total.matrixBuffers / n,
+                      static_cast<unsigned long long>(p.last.allocations), static_cast<unsigned long long>(p.last.bytes),
+                      p.peakRss / MB);
+        out += line;
+    }
+    return out;
+}
+
+void Perf::CountDraw(size_t vertices) {
+    ++gDrawCalls;
+    gVertices += vertices;
+}
+
+void Perf::FrameProfiler::BeginFrame() {
+    mCurrent = Frame{};
+    mFrameStart = mPhaseStart = SDL_GetPerformanceCounter();
+    mAllocStart = ProcessAllocs();
+    mMainAllocStart = ThreadAllocs();
+}
+
+void Perf::FrameProfiler::EndPhase(Phase phase) {
+    const uint64_t now = SDL_GetPerformanceCounter();
+    mCurrent.phaseMs[phase] += MsSince(mPhaseStart, now);
+    mPhaseStart = now;
+}
+
+float Perf::FrameProfiler::ElapsedMs() const {
+    return MsSince(mFrameStart, SDL_GetPerformanceCounter());
+}
+
+void Perf::FrameProfiler::EndFrame() {
+    mCurrent.totalMs     = MsSince(mFrameStart, SDL_GetPerformanceCounter());
+    const AllocCounters all = ProcessAllocs() - mAllocStart;
+    mCurrent.allocations     = all.allocations;
+    mCurrent.bytes           = all.bytes;
+    mCurrent.mainAllocations = (ThreadAllocs() - mMainAllocStart).allocations;
+    // draws issued between frames (atlas rebuilds from events) land in the next frame
+    mCurrent.drawCalls   = gDrawCalls;
+    mCurrent.vertices    = gVertices;
+    gDrawCalls = 0;
+    gVertices  = 0;
+    mLast = mCurrent;
+
+    // the slot about to be overwritten leaves the skipped count once the ring is full
+    if (mSkipCount == HISTORY && mSkipped[mSkipHead]) --mSkippedRecent;
+    mSkipped[mSkipHead] = mCurrent.skipped;
+    mSkipHead = (mSkipHead + 1) % HISTORY;
+    mSkipCount = std::min(mSkipCount + 1, HISTORY);
+    ++mFrames;
+    if (mCurrent.skipped) {
+        ++mSkippedRecent;
+        ++mFramesSkipped;
+        return;
+    }
+
+    mFrameMs[mHead] = mCurrent.totalMs;
+    mHead = (mHead + 1) % HISTORY;
+    mCount = std::min(mCount + 1, HISTORY);
+
+    // percentiles over the trailing window, the newest frame included
+    const size_t n = std::min(mCount, PERCENTILE_WINDOW);
+    for (size_t i = 0; i < n; ++i) mScratch[i] = FrameMs(mCount - n + i);
+    const auto rank = [n](float p) { return static_cast<size_t>(p * static_cast<float>(n - 1) + 0.5f); };
+    const size_t r50 = rank(0.50f), r99 = rank(0.99f);
+    std::nth_element(mScratch.begin(), mScratch.begin() + r99, mScratch.begin() + n);
+    const float p99 = mScratch[r99];
+    // everything left of r99 is <= it, so the median is found in that prefix
+    std::nth_element(mScratch.begin(), mScratch.begin() + r50, mScratch.begin() + r99);
+    const size_t newest = Slot(mCount - 1);
+    mP50[newest] = r50 < r99 ? mScratch[r50] : p99;
+    mP99[newest] = p99;
+}
@@ -0,0 +1,153 @@
+//
+// Created by Ben Meyers on 3/22/26.
+//
+
+#ifndef NEURAL_NETWORK_CIRCUIT_VISUALIZATION_PERF_H
+#define NEURAL_NETWORK_CIRCUIT_VISUALIZATION_PERF_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Cheap always-on counters for the sidebar HUD: per-phase frame times, draw calls reaching the
+// renderer, and heap allocations. With NN_ALLOC_TRACKING (CMake option, on by default) operator new/delete
+// are replaced in Perf.cpp to count calls and bytes; without it the heap counters read zero
+// (DynamicMatrix still counts its own buffers).
+#ifndef NN_ALLOC_TRACKING
+#define NN_ALLOC_TRACKING 1
+#endif
+
+namespace Perf {
+    struct AllocCounters {
+        uint64_t allocations = 0;
+        uint64_t frees       = 0;
+        uint64_t bytes       = 0;  // requested, not counting the allocator's own overhead
+        // DynamicMatrix buffers among the above
+        uint64_t matrixBuffers = 0;
+        uint64_t matrixBytes   = 0;
+
+        AllocCounters operator-(const AllocCounters& o) const {
+            return {allocations - o.allocations, frees - o.frees, bytes - o.bytes,
+                    matrixBuffers - o.matrixBuffers, matrixBytes - o.matrixBytes};
+        }
+    };
+
+    // since startup: every thread, or just the calling one
+    [[nodiscard]] AllocCounters ProcessAllocs();
+    [[nodiscard]] AllocCounters ThreadAllocs();
+    // process-wide count of heap allocations so far, every thread included
+    [[nodiscard]] inline uint64_t Allocations() { return ProcessAllocs().allocations; }
+    // bytes currently allocated through operator new, and the most there have ever been at once
+    [[nodiscard]] uint64_t LiveBytes();
+    [[nodiscard]] uint64_t PeakLiveBytes();
+    // the OS's high-water mark for this process' resident memory, 0 where it can't be asked
+    [[nodiscard]] uint64_t PeakRssBytes();
+
+    // what the calling thread allocates from construction until Delta(). for benchmarks and checks like
+    // "steady state allocates nothing": other threads' allocations never show up in it
+    class AllocProbe {
+    public:
+        AllocProbe() : mStart(ThreadAllocs()) {}
+        [[nodiscard]] AllocCounters Delta() const { return ThreadAllocs() - mStart; }
+    private:
+        AllocCounters mStart;
+    };
+
+    // named stretches of work whose allocations are worth watching on their own
+    enum AllocPhase { TRAIN_STEP, FORWARD, RENDER, ALLOC_PHASE_COUNT };
+    [[nodiscard]] const char* AllocPhaseName(AllocPhase phase);
+
+    struct PhaseAllocs {
+        uint64_t      calls = 0;
+        AllocCounters total;     // summed over every call
+        AllocCounters last;      // the most recent call
+        uint64_t      peakRss = 0;  // process peak RSS at the end of a recent call (sampled, it's a syscall)
+    };
+    [[nodiscard]] PhaseAllocs PhaseStats(AllocPhase phase);
+
+    // attributes the calling thread's allocations during its lifetime to `phase`
+    class PhaseScope {
+    public:
+        explicit PhaseScope(AllocPhase phase) : mPhase(phase) {}
+        ~PhaseScope();
+        PhaseScope(const PhaseScope&) = delete;
+        PhaseScope& operator=(const PhaseScope&) = delete;
+    private:
+        AllocPhase  mPhase;
+        AllocProbe  mProbe;
+    };
+
+    // process totals, live/peak bytes, peak RSS and the per-phase table, one line each
+    [[nodiscard]] std::string AllocReport();
+
+    // one draw call of `vertices` vertices went to the renderer. main thread only
+    void CountDraw(size_t vertices);
+
+    // TRAIN is training run on the main thread in whatever time the frame has left
+    enum Phase { INPUT, UPDATE, OUTPUT, TRAIN, PHASE_COUNT };
+
+    struct Frame {
+        std::array<float, PHASE_COUNT> phaseMs{};
+        float    totalMs     = 0.0f;
+        uint32_t drawCalls   = 0;
+        uint64_t vertices    = 0;
+        // every thread's, then the main thread's share
+        uint64_t allocations = 0;
+        uint64_t bytes       = 0;
+        uint64_t mainAllocations = 0;
+        // nothing had changed, so nothing was drawn or presented
+        bool     skipped     = false;
+    };
+
+    // times the phases of each RunIteration and keeps a short history for sparklines
+    class FrameProfiler {
+    public:
+        static constexpr size_t HISTORY = 240;           // frames shown in the sparklines
+        static constexpr size_t PERCENTILE_WINDOW = 120; // trailing frames each p50/p99 point covers
+
+        void BeginFrame();
+        // closes `phase`: everything since BeginFrame or the previous EndPhase
+        void EndPhase(Phase phase);
+        void EndFrame();
+        // time since BeginFrame, for spending whatever is left of a frame budget
+        [[nodiscard]] float ElapsedMs() const;
+        // the frame in progress left the previous one on screen
+        void MarkSkipped() { mCurrent.skipped = true; }
+
+        // the last completed frame
+        [[nodiscard]] const Frame& Last() const { return mLast; }
+
+        // history of drawn frames, i = 0 is the oldest still kept. skipped frames stay out of it:
+        // they cost next to nothing and would drag p50/p99 down exactly when idling
+        [[nodiscard]] size_t HistorySize() const { return mCount; }
+        [[nodiscard]] float FrameMs(size_t i) const { return mFrameMs[Slot(i)]; }
+        [[nodiscard]] float P50(size_t i) const { return mP50[Slot(i)]; }
+        [[nodiscard]] float P99(size_t i) const { return mP99[Slot(i)]; }
+        // share of the last HISTORY frames, drawn or not, that were skipped, in percent
+        [[nodiscard]] float SkippedPercent() const {
+            return mSkipCount > 0 ? 100.0f * static_cast<float>(mSkippedRecent) / static_cast<float>(mSkipCount) : 0.0f;
+        }
+        // since startup
+        [[nodiscard]] uint64_t Frames() const { return mFrames; }
+        [[nodiscard]] uint64_t FramesSkipped() const { return mFramesSkipped; }
+
+    private:
+        [[nodiscard]] size_t Slot(size_t i) const { return (mHead + HISTORY - mCount + i) % HISTORY; }
+
+        Frame    mCurrent, mLast;
+        uint64_t mFrameStart = 0, mPhaseStart = 0;
+        AllocCounters mAllocStart, mMainAllocStart;
+
+        std::array<float, HISTORY> mFrameMs{}, mP50{}, mP99{};
+        size_t mHead  = 0;  // next slot to write
+        size_t mCount = 0;
+        // every frame's skip flag, in a ring of its own
+        std::array<bool, HISTORY>  mSkipped{};
+        size_t   mSkipHead = 0, mSkipCount = 0, mSkippedRecent = 0;
+        uint64_t mFrames = 0, mFramesSkipped = 0;
+        std::array<float, PERCENTILE_WINDOW> mScratch{};
+    };
+}
+
+#endif //NEURAL_NETWORK_CIRCUIT_VISUALIZATION_PERF_H
@@ -0,0 +1,119 @@
+//
+// Created by Ben Meyers on 3/22/26.
+//
+
+#include "PerfHud.h"
+#include <cstdarg>
+#include <cstdio>
+#include "DrawComponent.h"
+#include "Game.h"
+#include "NeuralNetworkActor.h"
+#include "Perf.h"
+
+PerfHud::PerfHud() {
+    mDraw = CreateComponent<DrawComponent>();
+}
+
+void PerfHud::SetNetwork(const NeuralNetworkActor* nn) {
+    mNN = nn ? gGame.GetHandle(nn) : Handle<NeuralNetworkActor>();
+}
+
+void PerfHud::Text(float& y, const char* fmt, ...) {
+    char line[96];
+    va_list args;
+    va_start(args, fmt);
+    std::vsnprintf(line, sizeof(line), fmt, args);
+    va_end(args);
+    mDraw->AddText(Game::PLOT_WIDTH + PAD, y, line);
+    y += LINE_PIXELS;
+}
+
+void PerfHud::HandleUpdate(float deltaTime) {
+    Actor::HandleUpdate(deltaTime);
+    mRateTimer += deltaTime;
+    if (mRateTimer < RATE_WINDOW) return;
+    const NeuralNetworkActor* nn = gGame.Resolve(mNN);
+    const uint64_t steps = nn ? nn->TrainingSteps() : 0;
+    // the count restarts whenever background training does
+    mStepsPerSec = steps >= mRateSteps ? static_cast<float>(steps - mRateSteps) / mRateTimer : 0.0f;
+    mRateSteps = steps;
+    mRateTimer = 0.0f;
+    MarkDirty();
+}
+
+void PerfHud::HandleRender() {
+    const Perf::FrameProfiler& prof = gGame.GetProfiler();
+    const Perf::Frame& f = prof.Last();
+
+    // sidebar backdrop and the divider against the plot
+    mDraw->AddRect(Game::PLOT_WIDTH, 0.0f, Game::SIDEBAR_WIDTH, Game::WINDOW_HEIGHT, 18, 18, 22, Game::MAX_COLOR);
+    mDraw->AddLine(Game::PLOT_WIDTH, 0.0f, Game::PLOT_WIDTH, Game::WINDOW_HEIGHT, 60, 60, 70, Game::MAX_COLOR);
+
+    float y = PAD;
+    Text(y, "PERFORMANCE");
+    y += LINE_PIXELS * 0.5f;
+    Text(y, "frame   %6.2f ms  (%.0f fps)", f.totalMs, f.totalMs > 0.0f ? Game::MS_PER_SEC / f.totalMs : 0.0f);
+    Text(y, " input  %6.2f ms", f.phaseMs[Perf::INPUT]);
+    Text(y, " update %6.2f ms", f.phaseMs[Perf::UPDATE]);
+    Text(y, " output %6.2f ms  (incl. present)", f.phaseMs[Perf::OUTPUT]);
+    Text(y, " train  %6.2f ms  (frame budget, F)", f.phaseMs[Perf::TRAIN]);
+    y += LINE_PIXELS * 0.5f;
+    if (const NeuralNetworkActor* nn = gGame.Resolve(mNN)) {
+        Text(y, "train   %8.0f steps/s", mStepsPerSec);
+        Text(y, " last step %6.3f ms", nn->LastStepMs());
+        Text(y, "rebake  %5zu layers/frame", nn->LastRebakes());
+        Text(y, "edges   %7zu budget/layer ([ ])", nn->GetEdgeBudget());
+        Text(y, "view    x%-7.2f (wheel/drag, Home)", nn->GetZoom());
+    }
+    Text(y, "draw    %5u calls  %7llu verts", f.drawCalls, static_cast<unsigned long long>(f.vertices));
+    Text(y, "idle    %5.1f%% frames skipped (F8)", prof.SkippedPercent());
+    Text(y, "alloc   %5llu / frame (main %llu), %.1f KB", static_cast<unsigned long long>(f.allocations),
+         static_cast<unsigned long long>(f.mainAllocations), static_cast<double>(f.bytes) / 1024.0);
+    // what each phase allocated the last time it ran, on whichever thread ran it
+    for (int i = 0; i < Perf::ALLOC_PHASE_COUNT; ++i) {
+        const auto phase = static_cast<Perf::AllocPhase>(i);
+        const Perf::PhaseAllocs p = Perf::PhaseStats(phase);
+        if (p.calls == 0) continue;
+        Text(y, " %-10s %5llu allocs %4llu mats", Perf::AllocPhaseName(phase),
+             static_cast<unsigned long long>(p.last.allocations), static_cast<unsigned long long>(p.last.matrixBuffers));
+    }
+    constexpr double MB = 1024.0 * 1024.0;
+    Text(y, "heap    %.1f MB  peak %.1f  rss %.1f", static_cast<double>(Perf::LiveBytes()) / MB,
+         static_cast<double>(Perf::PeakLiveBytes()) / MB, static_cast<double>(Perf::PeakRssBytes()) / MB);
+    y += LINE_PIXELS * 0.5f;
+
+    const size_t n = prof.HistorySize();
+    if (n > 0) {
+        Text(y, "p50 %6.2f ms   p99 %6.2f ms", prof.P50(n - 1), prof.P99(n - 1));
+        DrawSparklines(y + LINE_PIXELS * 0.5f);
+    }
+}
+
+void PerfHud::DrawSparklines(float y) {
+    const Perf::FrameProfiler& prof = gGame.GetProfiler();
+    const size_t n = prof.HistorySize();
+    const float x0 = Game::PLOT_WIDTH + PAD;
+    const float w = Game::SIDEBAR_WIDTH - 2.0f * PAD;
+    mDraw->AddOutlineRect(x0, y, w, GRAPH_HEIGHT, 60, 60, 70, Game::MAX_COLOR);
+
+    // scale to the worst p99 on screen, but never tighter than two 60 Hz frames
+    float top = 2.0f * Game::MS_PER_SEC / static_cast<float>(Game::ESTIMATED_FPS);
+    for (size_t i = 0; i < n; ++i) top = Math::Max(top, prof.P99(i) * 1.1f);
+    const float bottom = y + GRAPH_HEIGHT;
+    const float sx = w / static_cast<float>(Perf::FrameProfiler::HISTORY - 1);
+    const float sy = GRAPH_HEIGHT / top;
+
+    // the 60 Hz budget as a reference line
+    const float budgetY = bottom - Game::MS_PER_SEC / static_cast<float>(Game::ESTIMATED_FPS) * sy;
+    mDraw->AddLine(x0, budgetY, x0 + w, budgetY, 50, 50, 90, Game::MAX_COLOR);
+
+    // newest frame at the right edge
+    const float xStart = x0 + w - static_cast<float>(n - 1) * sx;
+    for (size_t i = 1; i < n; ++i) {
+        const float xa = xStart + static_cast<float>(i - 1) * sx, xb = xa + sx;
+        mDraw->AddLine(xa, bottom - Math::Min(prof.FrameMs(i - 1), top) * sy,
+                       xb, bottom - Math::Min(prof.FrameMs(i), top) * sy, 110, 110, 110, Game::MAX_COLOR);
+        mDraw->AddLine(xa, bottom - prof.P50(i - 1) * sy, xb, bottom - prof.P50(i) * sy, 80, 220, 120, Game::MAX_COLOR);
+        mDraw->AddLine(xa, bottom - prof.P99(i - 1) * sy, xb, bottom - prof.P99(i) * sy, 240, 90, 80, Game::MAX_COLOR);
+    }
+}
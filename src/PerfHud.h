@@ -0,0 +1,46 @@
+//
+// Created by Ben Meyers on 3/22/26.
+//
+
+#ifndef NEURAL_NETWORK_CIRCUIT_VISUALIZATION_PERFHUD_H
+#define NEURAL_NETWORK_CIRCUIT_VISUALIZATION_PERFHUD_H
+
+#include <cstdint>
+#include "Actor.h"
+#include "Pool.h"
+
+class DrawComponent;
+class NeuralNetworkActor;
+
+// Live numbers in the sidebar: the last frame split by phase, training throughput, what reached
+// the renderer, allocations, and frame-time sparklines (raw, rolling p50, rolling p99).
+class PerfHud final : public Actor {
+    static constexpr float PAD = 12.0f;
+    static constexpr float LINE_PIXELS = 14.0f;
+    static constexpr float GRAPH_HEIGHT = 90.0f;
+    // how often steps/sec is resampled, and how often the HUD alone asks for a redraw when idle
+    static constexpr float RATE_WINDOW = 0.5f;
+public:
+    PerfHud();
+    // whose training the HUD reports on
+    void SetNetwork(const NeuralNetworkActor* nn);
+
+protected:
+    void HandleRender() override;
+    void HandleUpdate(float deltaTime) override;
+
+private:
+    // one line of formatted text at the cursor, which then moves down a line
+    void Text(float& y, const char* fmt, ...);
+    void DrawSparklines(float y);
+
+    DrawComponent* mDraw = nullptr;
+    // by handle: the benchmark (or anything else) may replace the network under the HUD
+    Handle<NeuralNetworkActor> mNN;
+
+    float    mRateTimer = 0.0f;
+    uint64_t mRateSteps = 0;
+    float    mStepsPerSec = 0.0f;
+};
+
+#endif //NEURAL_NETWORK_CIRCUIT_VISUALIZATION_PERFHUD_H
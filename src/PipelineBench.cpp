@@ -0,0 +1,81 @@
+//
+// Created by Ben Meyers on 3/27/26.
+//
+
+#include "PipelineBench.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "NeuralNetwork.h"
+#include "SDL3/SDL.h"
+
+std::string PipelineBench::Config() const {
+    // the activation's own cell counts as a neuron, so one '*' fewer (as in RenderBench)
+    std::string row;
+    for (size_t i = 1; i < mOptions.width; ++i) row += "*|";
+    std::string cfg = "|input|" + row + "\n";
+    for (size_t l = 1; l < mOptions.depth; ++l) cfg += "|ReLU|" + row + "\n";
+    cfg += "|softmax|" + row + "\n";
+    return cfg;
+}
+
+void PipelineBench::Run(const std::string& configPath) const {
+    using Clock = std::chrono::steady_clock;
+    NeuralNetwork base;
+    if (mOptions.width > 0) {
+        std::istringstream config(Config());
+        base.FromStream(config);
+    } else {
+        base.FromConfig(configPath);
+    }
+    const std::vector<Layer>& layers = base.Layers();
+    const size_t in = layers.front().InSize(), out = layers.back().OutSize();
+
+    // a fixed batch, the same for every stage count: smooth inputs, one-hot targets cycling through the outputs
+    std::vector<DynamicMatrix> inputs, targets;
+    for (size_t m = 0; m < mOptions.micro; ++m) {
+        DynamicMatrix x(in, 1), t(out, 1);
+        for (size_t i = 0; i < in; ++i)
+            x.at(i, 0) = std::sin(1.3f * static_cast<float>(m) + 0.7f * static_cast<float>(i));
+        t.at(m % out, 0) = 1.0f;
+        inputs.push_back(std::move(x));
+        targets.push_back(std::move(t));
+    }
+
+    const size_t maxStages = std::min(mOptions.stages, layers.size());
+    SDL_Log("pipeline: %zu layers, %zu steps of %zu micro-batches per case, %u hardware threads",
+            layers.size(), mOptions.steps, mOptions.micro, std::thread::hardware_concurrency());
+    NeuralNetwork reference;
+    double baseRate = 0.0;
+    for (size_t stages = 1; stages <= maxStages; ++stages) {
+        NeuralNetwork nn = base;
+        PipelineStats stats;
+        float bubble = 0.0f;
+        const auto start = Clock::now();
+        for (size_t step = 0; step < mOptions.steps; ++step) {
+            stats = nn.TrainPipelined(inputs, targets, LEARNING_RATE, stages);
+            bubble += stats.bubbleFraction;
+        }
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        const double rate = seconds > 0.0 ? static_cast<double>(mOptions.steps) / seconds : 0.0;
+        if (stages == 1) {
+            reference = nn;
+            baseRate = rate;
+        }
+
+        // every stage count runs the same arithmetic in the same order, so this should stay 0
+        float drift = 0.0f;
+        for (size_t l = 0; l < layers.size(); ++l) {
+            const DynamicMatrix& a = nn.Layers()[l].weights;
+            const DynamicMatrix& b = reference.Layers()[l].weights;
+            for (size_t i = 0; i < a.Size(); ++i) drift = std::max(drift, std::fabs(a.Data()[i] - b.Data()[i]));
+        }
+        SDL_Log("pipeline %2zu stages: %9.1f steps/s (%10.1f samples/s, %.2fx)  bubble %5.1f%%  loss %.4f  drift %g",
+                stats.stages, rate, rate * static_cast<double>(mOptions.micro), baseRate > 0.0 ? rate / baseRate : 0.0,
+                100.0 * static_cast<double>(bubble) / static_cast<double>(std::max<size_t>(mOptions.steps, 1)),
+                static_cast<double>(stats.loss), static_cast<double>(drift));
+    }
+}
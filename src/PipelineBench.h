@@ -0,0 +1,38 @@
+//
+// Created by Ben Meyers on 3/27/26.
+//
+
+#ifndef NEURAL_NETWORK_CIRCUIT_VISUALIZATION_PIPELINEBENCH_H
+#define NEURAL_NETWORK_CIRCUIT_VISUALIZATION_PIPELINEBENCH_H
+
+#include <cstddef>
+#include <string>
+
+// --pipeline: trains copies of one network with TrainPipelined on 1, 2, ... stages and logs, per stage
+// count, the throughput, the bubble fraction, the loss, and how far the weights drifted from the
+// one-stage run (0 when the stages agree bit for bit). no window; it runs before Initialize and exits
+class PipelineBench {
+public:
+    struct Options {
+        size_t stages = 0;  // most stages to try, capped at the layer count. 0 = no benchmark
+        size_t steps  = 50; // TrainPipelined calls per stage count
+        size_t micro  = 16; // micro-batches per call
+        size_t width  = 0;  // 0 = the network in nn.cfg, else `depth` ReLU layers this wide
+        size_t depth  = 8;
+    };
+
+    [[nodiscard]] Options& GetOptions() { return mOptions; }
+    [[nodiscard]] bool Enabled() const { return mOptions.stages > 0; }
+
+    // configPath is used when no width is given. throws whatever loading or training throws
+    void Run(const std::string& configPath) const;
+
+private:
+    static constexpr float LEARNING_RATE = 0.075f;  // same step as the visualizer trains with
+    // nn.cfg text for the synthesized network
+    [[nodiscard]] std::string Config() const;
+
+    Options mOptions;
+};
+
+#endif //NEURAL_NETWORK_CIRCUIT_VISUALIZATION_PIPELINEBENCH_H
@@ -0,0 +1,172 @@
+//
+// Created by Ben Meyers on 3/26/26.
+//
+
+#ifndef NEURAL_NETWORK_CIRCUIT_VISUALIZATION_POOL_H
+#define NEURAL_NETWORK_CIRCUIT_VISUALIZATION_POOL_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+// small dense id per type, in order of first use; indexes the per-type pools in Game
+namespace PoolDetail {
+    inline uint32_t NextTypeId() {
+        static uint32_t next = 0;
+        return next++;
+    }
+}
+template <typename T>
+uint32_t PoolTypeId() {
+    static const uint32_t id = PoolDetail::NextTypeId();
+    return id;
+}
+
+// refers to an object in a Pool<T> without owning it. once the object is destroyed the slot's generation
+// moves on, so the handle resolves to nullptr instead of to whatever reuses the slot
+template <typename T>
+struct Handle {
+    static constexpr uint32_t INVALID = UINT32_MAX;
+    uint32_t index      = INVALID;
+    uint32_t generation = 0;
+
+    [[nodiscard]] bool Valid() const { return index != INVALID; }
+    bool operator==(const Handle&) const = default;
+};
+
+// Objects of one type in fixed-size chunks of contiguous slots. Objects never move, so raw pointers
+// stay good for an object's lifetime, and ForEach still walks memory in order a chunk at a time.
+// Freed slots are reused before new ones, newest first.
+template <typename T, size_t CHUNK = 64>
+class Pool {
+public:
+    Pool() = default;
+    ~Pool() { Clear(); }
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+
+    template <typename... Args>
+    T* Emplace(Args&&... args) {
+        uint32_t index;
+        if (!mFree.empty()) {
+            index = mFree.back();
+            mFree.pop_back();
+        } else {
+            if (mEnd == mChunks.size() * CHUNK) mChunks.push_back(std::make_unique<Chunk>());
+            index = mEnd++;
+        }
+        Chunk& chunk = *mChunks[index / CHUNK];
+        const size_t i = index % CHUNK;
+        T* object;
+        try {
+            object = new (chunk.Slot(i)) T(std::forward<Args>(args)...);
+        } catch (...) {
+            mFree.push_back(index);
+            throw;
+        }
+        chunk.live[i] = true;
+        chunk.born[i] = mEmplaced++;
+        ++mLive;
+        return object;
+    }
+
+    // destroys the object; handles to it go stale. not while ForEach is walking this pool
+    void Erase(const T* object) {
+        const uint32_t index = IndexOf(object);
+        if (index == Handle<T>::INVALID) return;
+        Chunk& chunk = *mChunks[index / CHUNK];
+        const size_t i = index % CHUNK;
+        chunk.At(i)->~T();
+        chunk.live[i] = false;
+        ++chunk.generation[i];
+        mFree.push_back(index);
+        --mLive;
+    }
+
+    [[nodiscard]] Handle<T> HandleOf(const T* object) const {
+        const uint32_t index = IndexOf(object);
+        if (index == Handle<T>::INVALID) return {};
+        return {index, mChunks[index / CHUNK]->generation[index % CHUNK]};
+    }
+    [[nodiscard]] T* Get(Handle<T> handle) const {
+        if (handle.index >= mEnd) return nullptr;
+        Chunk& chunk = *mChunks[handle.index / CHUNK];
+        const size_t i = handle.index % CHUNK;
+        return chunk.live[i] && chunk.generation[i] == handle.generation ? chunk.At(i) : nullptr;
+    }
+    // the live object in slot `index`, or nullptr
+    [[nodiscard]] T* At(uint32_t index) const {
+        if (index >= mEnd) return nullptr;
+        Chunk& chunk = *mChunks[index / CHUNK];
+        return chunk.live[index % CHUNK] ? chunk.At(index % CHUNK) : nullptr;
+    }
+    // slot of an object in this pool, INVALID for anything else (checks the address, so any pointer is safe)
+    [[nodiscard]] uint32_t IndexOf(const void* object) const {
+        const auto* p = static_cast<const std::byte*>(object);
+        for (size_t c = 0; c < mChunks.size(); ++c) {
+            const std::byte* base = mChunks[c]->storage;
+            if (p < base || p >= base + sizeof(Chunk::storage)) continue;
+            const auto offset = static_cast<size_t>(p - base);
+            if (offset % sizeof(T) != 0) return Handle<T>::INVALID;
+            const auto index = static_cast<uint32_t>(c * CHUNK + offset / sizeof(T));
+            return index < mEnd && mChunks[c]->live[index % CHUNK] ? index : Handle<T>::INVALID;
+        }
+        return Handle<T>::INVALID;
+    }
+
+    [[nodiscard]] size_t Size() const { return mLive; }
+    // one past the highest slot ever used, for walking slots by index
+    [[nodiscard]] uint32_t End() const { return mEnd; }
+
+    // f(T&) for each live object in slot order. objects emplaced meanwhile wait for the next walk,
+    // including those that reuse a freed slot the walk hasn't reached yet
+    template <typename F>
+    void ForEach(F&& f) const {
+        const uint32_t end = mEnd;
+        const uint64_t before = mEmplaced;
+        for (uint32_t c = 0; c * CHUNK < end; ++c) {
+            Chunk& chunk = *mChunks[c];
+            const size_t n = end - c * CHUNK < CHUNK ? end - c * CHUNK : CHUNK;
+            for (size_t i = 0; i < n; ++i)
+                if (chunk.live[i] && chunk.born[i] < before) f(*chunk.At(i));
+        }
+    }
+
+    void Clear() {
+        for (uint32_t index = 0; index < mEnd; ++index) {
+            Chunk& chunk = *mChunks[index / CHUNK];
+            const size_t i = index % CHUNK;
+            if (!chunk.live[i]) continue;
+            chunk.At(i)->~T();
+            chunk.live[i] = false;
+            ++chunk.generation[i];
+        }
+        // chunks stay allocated for reuse; every slot is free again, lowest first
+        mFree.clear();
+        for (uint32_t index = mEnd; index > 0; --index) mFree.push_back(index - 1);
+        mLive = 0;
+    }
+
+private:
+    struct Chunk {
+        alignas(T) std::byte storage[CHUNK * sizeof(T)];
+        std::array<uint32_t, CHUNK> generation{};
+        std::array<bool, CHUNK>     live{};
+        std::array<uint64_t, CHUNK> born{};  // mEmplaced when the live object was made
+
+        void* Slot(size_t i) { return storage + i * sizeof(T); }
+        T* At(size_t i) { return std::launder(reinterpret_cast<T*>(storage + i * sizeof(T))); }
+    };
+
+    std::vector<std::unique_ptr<Chunk>> mChunks;
+    std::vector<uint32_t> mFree;
+    uint32_t mEnd  = 0;
+    size_t   mLive = 0;
+    uint64_t mEmplaced = 0;  // objects ever emplaced
+};
+
+#endif //NEURAL_NETWORK_CIRCUIT_VISUALIZATION_POOL_H
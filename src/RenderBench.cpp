@@ -0,0 +1,138 @@
+//
+// Created by Ben Meyers on 3/25/26.
+//
+
+#include "RenderBench.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include "SDL3/SDL.h"
+
+namespace {
+    // per-frame means plus the frame-time distribution of one case
+    struct Summary {
+        float  meanMs = 0.0f, p50Ms = 0.0f, p99Ms = 0.0f, maxMs = 0.0f;
+        float  updateMs = 0.0f, outputMs = 0.0f;
+        double drawCalls = 0.0, vertices = 0.0;
+        double allocations = 0.0, bytes = 0.0, mainAllocations = 0.0;
+        uint64_t maxAllocations = 0;
+    };
+
+    Summary Summarize(const std::vector<Perf::Frame>& frames) {
+        Summary s;
+        if (frames.empty()) return s;
+        std::vector<float> ms;
+        ms.reserve(frames.size());
+        for (const Perf::Frame& f : frames) {
+            ms.push_back(f.totalMs);
+            s.meanMs          += f.totalMs;
+            s.updateMs        += f.phaseMs[Perf::UPDATE];
+            s.outputMs        += f.phaseMs[Perf::OUTPUT];
+            s.drawCalls       += f.drawCalls;
+            s.vertices        += static_cast<double>(f.vertices);
+            s.allocations     += static_cast<double>(f.allocations);
+            s.bytes           += static_cast<double>(f.bytes);
+            s.mainAllocations += static_cast<double>(f.mainAllocations);
+            s.maxAllocations   = std::max(s.maxAllocations, f.allocations);
+        }
+        const auto n = static_cast<float>(frames.size());
+        s.meanMs /= n;
+        s.updateMs /= n;
+        s.outputMs /= n;
+        s.drawCalls /= n;
+        s.vertices /= n;
+        s.allocations /= n;
+        s.bytes /= n;
+        s.mainAllocations /= n;
+
+        // same nearest-rank percentiles as the HUD's FrameProfiler
+        std::sort(ms.begin(), ms.end());
+        const auto rank = [&ms](float p) { return static_cast<size_t>(p * static_cast<float>(ms.size() - 1) + 0.5f); };
+        s.p50Ms = ms[rank(0.50f)];
+        s.p99Ms = ms[rank(0.99f)];
+        s.maxMs = ms.back();
+        return s;
+    }
+}
+
+bool RenderBench::ParseSizes(const char* text, std::vector<size_t>& sizes) {
+    sizes.clear();
+    const char* p = text;
+    for (;;) {
+        char* end = nullptr;
+        const unsigned long long n = std::strtoull(p, &end, 10);
+        if (end == p || n == 0) return false;
+        sizes.push_back(static_cast<size_t>(n));
+        if (*end == '\0') return true;
+        if (*end != ',') return false;
+        p = end + 1;
+    }
+}
+
+std::string RenderBench::Config() const {
+    if (Done()) return {};
+    const size_t neurons = mOptions.sizes[mCase];
+    // the activation's own cell counts as a neuron, so one '*' fewer
+    std::string row;
+    row.reserve(neurons * 2);
+    for (size_t i = 1; i < neurons; ++i) row += "*|";
+
+    // same shape as nn.cfg: ReLU hidden columns into a softmax output
+    std::string cfg = "|input|" + row + "\n";
+    for (size_t c = 2; c < mOptions.columns; ++c) cfg += "|ReLU|" + row + "\n";
+    cfg += "|softmax|" + row + "\n";
+    return cfg;
+}
+
+bool RenderBench::Record(const Perf::Frame& frame) {
+    if (Done()) return false;
+    if (mSeen++ == 0) {
+        mCurrent = {};
+        mCurrent.neurons = mOptions.sizes[mCase];
+        mCurrent.firstMs = frame.totalMs;
+        // no growth mid-case, so the bench's own bookkeeping never shows up in the counters it reads
+        mCurrent.frames.reserve(mOptions.frames);
+    }
+    if (mSeen <= mOptions.warmup) return false;
+    mCurrent.frames.push_back(frame);
+    if (mCurrent.frames.size() < mOptions.frames) return false;
+
+    const Summary s = Summarize(mCurrent.frames);
+    SDL_Log("bench %6zu neurons/layer: %7.3f ms/frame (p99 %7.3f, render %7.3f)  %6.0f draws  %9.0f verts  %7.1f allocs",
+            mCurrent.neurons, static_cast<double>(s.meanMs), static_cast<double>(s.p99Ms),
+            static_cast<double>(s.outputMs), s.drawCalls, s.vertices, s.allocations);
+    mResults.push_back(std::move(mCurrent));
+    mCurrent = {};
+    mSeen = 0;
+    ++mCase;
+    return true;
+}
+
+bool RenderBench::WriteJson(int width, int height) const {
+    std::FILE* f = std::fopen(mOptions.outPath.c_str(), "w");
+    if (!f) {
+        SDL_Log("couldn't write benchmark results to %s", mOptions.outPath.c_str());
+        return false;
+    }
+    std::fprintf(f, "{\n  \"renderer\": \"software\",\n  \"width\": %d,\n  \"height\": %d,\n", width, height);
+    std::fprintf(f, "  \"columns\": %zu,\n  \"frames\": %zu,\n  \"warmup\": %zu,\n  \"cases\": [",
+                 mOptions.columns, mOptions.frames, mOptions.warmup);
+    for (size_t i = 0; i < mResults.size(); ++i) {
+        const Case& c = mResults[i];
+        const Summary s = Summarize(c.frames);
+        const size_t weights = (mOptions.columns - 1) * c.neurons * c.neurons;
+        std::fprintf(f, "%s\n    {\"neurons\": %zu, \"weights\": %zu, \"first_frame_ms\": %.4f,\n",
+                     i ? "," : "", c.neurons, weights, static_cast<double>(c.firstMs));
+        std::fprintf(f, "     \"ms\": {\"mean\": %.4f, \"p50\": %.4f, \"p99\": %.4f, \"max\": %.4f},\n",
+                     static_cast<double>(s.meanMs), static_cast<double>(s.p50Ms), static_cast<double>(s.p99Ms),
+                     static_cast<double>(s.maxMs));
+        std::fprintf(f, "     \"update_ms\": %.4f, \"render_ms\": %.4f, \"draw_calls\": %.2f, \"vertices\": %.1f,\n",
+                     static_cast<double>(s.updateMs), static_cast<double>(s.outputMs), s.drawCalls, s.vertices);
+        std::fprintf(f, "     \"allocations\": %.2f, \"max_allocations\": %llu, \"main_allocations\": %.2f, \"bytes\": %.1f}",
+                     s.allocations, static_cast<unsigned long long>(s.maxAllocations), s.mainAllocations, s.bytes);
+    }
+    std::fprintf(f, "\n  ]\n}\n");
+    const bool ok = std::fclose(f) == 0;
+    if (ok) SDL_Log("benchmark results written to %s", mOptions.outPath.c_str());
+    return ok;
+}
@@ -0,0 +1,54 @@
+//
+// Created by Ben Meyers on 3/25/26.
+//
+
+#ifndef NEURAL_NETWORK_CIRCUIT_VISUALIZATION_RENDERBENCH_H
+#define NEURAL_NETWORK_CIRCUIT_VISUALIZATION_RENDERBENCH_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "Perf.h"
+
+// --bench: renders synthesized networks of growing size offscreen through the normal game loop, one
+// case per size, and summarizes what the FrameProfiler saw as JSON. The first `warmup` frames of each
+// case are left out of the summary, since that's where weight-layer caches get baked.
+class RenderBench {
+public:
+    struct Options {
+        std::vector<size_t> sizes;  // neurons per layer, one case each. empty = no benchmark
+        size_t columns = 4;         // input, hidden..., output
+        size_t frames  = 120;       // measured frames per case
+        size_t warmup  = 10;
+        std::string outPath = "render_bench.json";
+    };
+
+    // "16,64,256" -> {16, 64, 256}; false on anything else
+    static bool ParseSizes(const char* text, std::vector<size_t>& sizes);
+
+    [[nodiscard]] Options& GetOptions() { return mOptions; }
+    [[nodiscard]] bool Enabled() const { return !mOptions.sizes.empty(); }
+    [[nodiscard]] bool Done() const { return mCase >= mOptions.sizes.size(); }
+
+    // nn.cfg text for the current case: `columns` dense columns of sizes[case] neurons
+    [[nodiscard]] std::string Config() const;
+    // call once per completed frame. returns true when that frame finished the current case
+    bool Record(const Perf::Frame& frame);
+    // every finished case so far. false, after logging why, if the file can't be written
+    bool WriteJson(int width, int height) const;
+
+private:
+    struct Case {
+        size_t neurons = 0;
+        float  firstMs = 0.0f;  // frame 0, caches cold
+        std::vector<Perf::Frame> frames;
+    };
+
+    Options           mOptions;
+    size_t            mCase = 0;
+    size_t            mSeen = 0;  // frames of the current case, warmup included
+    Case              mCurrent;
+    std::vector<Case> mResults;
+};
+
+#endif //NEURAL_NETWORK_CIRCUIT_VISUALIZATION_RENDERBENCH_H
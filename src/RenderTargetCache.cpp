@@ -0,0 +1,71 @@
+//
+// Created by Ben Meyers on 3/15/26.
+//
+
+#include "RenderTargetCache.h"
+#include "Game.h"
+
+RenderTargetCache::~RenderTargetCache() {
+    Destroy();
+}
+
+void RenderTargetCache::Destroy() {
+    for (auto& e : mEntries)
+        if (e.texture) SDL_DestroyTexture(e.texture);
+    mEntries.clear();
+}
+
+void RenderTargetCache::Invalidate() {
+    for (auto& e : mEntries) e.valid = false;
+}
+
+size_t RenderTargetCache::TakeRedrawCount() {
+    const size_t n = mRedraws;
+    mRedraws = 0;
+    return n;
+}
+
+SDL_Texture* RenderTargetCache::Acquire(SDL_Renderer* renderer, size_t slot, int w, int h, uint64_t version,
+                                        const std::function<void(SDL_Renderer*)>& draw) {
+    if (w <= 0 || h <= 0) return nullptr;
+    if (slot >= mEntries.size()) mEntries.resize(slot + 1);
+    Entry& e = mEntries[slot];
+
+    const uint64_t epoch = gGame.GetRenderTargetEpoch();
+    // a device reset (new epoch) or a size change needs a fresh texture, not just a redraw
+    if (!e.texture || e.w != w || e.h != h || e.epoch != epoch) {
+        if (e.texture) SDL_DestroyTexture(e.texture);
+        e.texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET, w, h);
+        if (!e.texture) {
+            e.valid = false;
+            return nullptr;
+        }
+        SDL_SetTextureBlendMode(e.texture, SDL_BLENDMODE_BLEND);
+        e.w = w;
+        e.h = h;
+        e.valid = false;
+    }
+    if (e.valid && e.version == version) return e.texture;
+
+    // redraw into the target, leaving the renderer's target and draw state as we found them
+    SDL_Texture* previous = SDL_GetRenderTarget(renderer);
+    Uint8 r, g, b, a;
+    SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+    SDL_BlendMode blend;
+    SDL_GetRenderDrawBlendMode(renderer, &blend);
+
+    SDL_SetRenderTarget(renderer, e.texture);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderClear(renderer);
+    draw(renderer);
+
+    SDL_SetRenderTarget(renderer, previous);
+    SDL_SetRenderDrawColor(renderer, r, g, b, a);
+    SDL_SetRenderDrawBlendMode(renderer, blend);
+
+    e.version = version;
+    e.epoch = epoch;
+    e.valid = true;
+    ++mRedraws;
+    return e.texture;
+}
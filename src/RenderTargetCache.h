@@ -0,0 +1,47 @@
+//
+// Created by Ben Meyers on 3/15/26.
+//
+
+#ifndef NEURAL_NETWORK_CIRCUIT_VISUALIZATION_RENDERTARGETCACHE_H
+#define NEURAL_NETWORK_CIRCUIT_VISUALIZATION_RENDERTARGETCACHE_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "SDL3/SDL_render.h"
+
+// A set of offscreen render-target textures, one per slot, that are only redrawn when stale.
+// A slot is stale when its size changes, when the caller's version for it changes
+// (e.g. a layer's weight version), or after the renderer loses its targets.
+class RenderTargetCache {
+public:
+    RenderTargetCache() = default;
+    ~RenderTargetCache();
+    RenderTargetCache(const RenderTargetCache&) = delete;
+    RenderTargetCache& operator=(const RenderTargetCache&) = delete;
+
+    // texture for `slot`, at w x h pixels. if it is stale, `draw` is called with the target bound
+    // and cleared to transparent; the previous target is restored afterwards. nullptr if the texture can't be made
+    SDL_Texture* Acquire(SDL_Renderer* renderer, size_t slot, int w, int h, uint64_t version,
+                         const std::function<void(SDL_Renderer*)>& draw);
+
+    // mark every slot stale without freeing anything (new network, same renderer)
+    void Invalidate();
+    void Destroy();
+
+    // how many slots were redrawn since the last call (the HUD shows it per frame)
+    size_t TakeRedrawCount();
+
+private:
+    struct Entry {
+        SDL_Texture* texture = nullptr;
+        int w = 0, h = 0;
+        uint64_t version = 0;
+        uint64_t epoch = 0;  // Game's render-target epoch when this was drawn
+        bool valid = false;
+    };
+    std::vector<Entry> mEntries;
+    size_t mRedraws = 0;
+};
+
+#endif //NEURAL_NETWORK_CIRCUIT_VISUALIZATION_RENDERTARGETCACHE_H
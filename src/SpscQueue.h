@@ -0,0 +1,78 @@
+//
+// Created by Ben Meyers on 3/9/26.
+//
+
+#ifndef NEURAL_NETWORK_CIRCUIT_VISUALIZATION_SPSCQUEUE_H
+#define NEURAL_NETWORK_CIRCUIT_VISUALIZATION_SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <thread>
+#include <vector>
+
+// Bounded lock-free single-producer / single-consumer ring buffer.
+// Exactly one thread may Push and exactly one (other) thread may Pop.
+template<typename T>
+class SpscQueue {
+    std::vector<std::optional<T>> mSlots;
+    size_t mMask;
+
+    // producer writes mTail, consumer writes mHead; separate cache lines so they don't ping-pong
+    alignas(64) std::atomic<size_t> mHead{0};
+    alignas(64) std::atomic<size_t> mTail{0};
+    std::atomic<bool> mClosed{false};
+
+public:
+    // capacity is rounded up to a power of two so wrapping is a mask
+    explicit SpscQueue(size_t capacity) {
+        size_t cap = 2;
+        while (cap < capacity) cap <<= 1;
+        mSlots.resize(cap);
+        mMask = cap - 1;
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // returns false if full
+    bool TryPush(T&& value) {
+        const size_t tail = mTail.load(std::memory_order_relaxed);
+        if (tail - mHead.load(std::memory_order_acquire) > mMask) return false;
+        mSlots[tail & mMask].emplace(std::move(value));
+        mTail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // returns nullopt if empty
+    std::optional<T> TryPop() {
+        const size_t head = mHead.load(std::memory_order_relaxed);
+        if (head == mTail.load(std::memory_order_acquire)) return std::nullopt;
+        std::optional<T> out = std::move(mSlots[head & mMask]);
+        mSlots[head & mMask].reset();
+        mHead.store(head + 1, std::memory_order_release);
+        return out;
+    }
+
+    // spinning versions for pipeline stages, which have nothing else to do while they wait.
+    // both give up once the queue is closed: Push drops the value, Pop returns nullopt
+    void Push(T&& value) {
+        while (!TryPush(std::move(value))) {
+            if (Closed()) return;
+            std::this_thread::yield();
+        }
+    }
+    std::optional<T> Pop() {
+        for (;;) {
+            if (Closed()) return std::nullopt;
+            if (auto v = TryPop()) return v;
+            std::this_thread::yield();
+        }
+    }
+
+    // any thread: abandon the exchange, so a side spinning on the other one isn't left waiting forever
+    void Close() { mClosed.store(true, std::memory_order_release); }
+    [[nodiscard]] bool Closed() const { return mClosed.load(std::memory_order_acquire); }
+};
+
+#endif //NEURAL_NETWORK_CIRCUIT_VISUALIZATION_SPSCQUEUE_H
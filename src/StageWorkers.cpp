@@ -0,0 +1,112 @@
+//
+// Created by Ben Meyers on 3/28/26.
+//
+
+#include "StageWorkers.h"
+#include <utility>
+#include "Trace.h"
+
+#if defined(__linux__) && !defined(__EMSCRIPTEN__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// keep a stage's thread on one core (the stage-th of those this process may use, so stages spread out).
+// best effort: elsewhere, or with a single core, the OS places it
+static void PinToCore(std::thread& thread, size_t stage) {
+#if defined(__linux__) && !defined(__EMSCRIPTEN__)
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return;
+    const int cores = CPU_COUNT(&allowed);
+    if (cores < 2) return;
+    int pick = static_cast<int>(stage % static_cast<size_t>(cores));
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (!CPU_ISSET(cpu, &allowed) || pick-- > 0) continue;
+        cpu_set_t one;
+        CPU_ZERO(&one);
+        CPU_SET(cpu, &one);
+        pthread_setaffinity_np(thread.native_handle(), sizeof(one), &one);
+        return;
+    }
+#else
+    (void)thread;
+    (void)stage;
+#endif
+}
+
+StageWorkers::~StageWorkers() {
+    Stop();
+}
+
+void StageWorkers::Stop() {
+    {
+        std::lock_guard lock(mMutex);
+        mStop = true;
+    }
+    mWake.notify_all();
+    for (std::thread& t : mThreads) t.join();
+    mThreads.clear();
+    mStop = false;
+}
+
+void StageWorkers::Run(size_t stages, const std::function<void(size_t)>& stage) {
+    if (stages == 0) return;
+    // start from the current generation so a new worker doesn't replay the last run
+    while (mThreads.size() + 1 < stages) {
+        const size_t s = mThreads.size() + 1;
+        mThreads.emplace_back(&StageWorkers::Worker, this, s, mGeneration);
+        PinToCore(mThreads.back(), s);
+    }
+
+    {
+        std::lock_guard lock(mMutex);
+        mJob    = &stage;
+        mStages = stages;
+        mActive = stages - 1;
+        mError  = nullptr;
+        ++mGeneration;
+    }
+    mWake.notify_all();
+    try {
+        stage(0);
+    } catch (...) {
+        Record(std::current_exception());
+    }
+
+    // every stage has to check out before `stage` (and whatever it captured) can go away
+    std::unique_lock lock(mMutex);
+    mDone.wait(lock, [this] { return mActive == 0; });
+    mJob = nullptr;
+    if (mError) std::rethrow_exception(std::exchange(mError, nullptr));
+}
+
+void StageWorkers::Record(std::exception_ptr error) {
+    std::lock_guard lock(mMutex);
+    if (!mError) mError = std::move(error);
+}
+
+void StageWorkers::Worker(size_t stage, uint64_t seen) {
+    NN_TRACE_THREAD("pipeline stage");
+    for (;;) {
+        const std::function<void(size_t)>* job;
+        {
+            std::unique_lock lock(mMutex);
+            mWake.wait(lock, [&] { return mStop || mGeneration != seen; });
+            if (mStop) return;
+            seen = mGeneration;
+            // a run with fewer stages leaves this worker asleep
+            if (stage >= mStages) continue;
+            job = mJob;
+        }
+        // an exception must not leave the thread (that's std::terminate); the caller rethrows it
+        try {
+            (*job)(stage);
+        } catch (...) {
+            Record(std::current_exception());
+        }
+        {
+            std::lock_guard lock(mMutex);
+            if (--mActive == 0) mDone.notify_one();
+        }
+    }
+}
@@ -0,0 +1,51 @@
+//
+// Created by Ben Meyers on 3/28/26.
+//
+
+#ifndef NEURAL_NETWORK_CIRCUIT_VISUALIZATION_STAGEWORKERS_H
+#define NEURAL_NETWORK_CIRCUIT_VISUALIZATION_STAGEWORKERS_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Long-lived threads for pipeline stages: stage s > 0 always runs on the same worker (pinned to a core
+// where the OS allows it), so its layers stay warm in that core's cache from one call to the next.
+// Unlike ThreadPool, every stage is guaranteed a thread of its own, since stages block on each other.
+// Workers sleep between calls. One Run at a time, from one thread.
+class StageWorkers {
+public:
+    StageWorkers() = default;
+    ~StageWorkers();
+    // threads aren't copied: a copied (or moved) network starts its own on its first pipelined step
+    StageWorkers(const StageWorkers&) {}
+    StageWorkers& operator=(const StageWorkers&) { return *this; }
+
+    // stage(s) for every s in [0, stages): 0 on the caller, the rest on their workers (started on first use).
+    // returns once all have; the first exception a stage threw is rethrown here
+    void Run(size_t stages, const std::function<void(size_t)>& stage);
+    void Stop();
+
+private:
+    void Worker(size_t stage, uint64_t seen);
+    void Record(std::exception_ptr error);
+
+    std::vector<std::thread> mThreads;  // mThreads[i] runs stage i + 1
+    std::mutex               mMutex;
+    std::condition_variable  mWake;  // workers: a new run (or stop) is posted
+    std::condition_variable  mDone;  // caller: the last stage of the run finished
+
+    // current run; written under mMutex before mGeneration ticks
+    const std::function<void(size_t)>* mJob = nullptr;
+    size_t             mStages = 0;
+    size_t             mActive = 0;  // workers still inside the current run
+    uint64_t           mGeneration = 0;
+    bool               mStop = false;
+    std::exception_ptr mError;
+};
+
+#endif //NEURAL_NETWORK_CIRCUIT_VISUALIZATION_STAGEWORKERS_H
@@ -0,0 +1,96 @@
+//
+// Created by Ben Meyers on 3/21/26.
+//
+
+#include "ThreadPool.h"
+#include <utility>
+#include "SDL3/SDL.h"
+#include "Trace.h"
+
+ThreadPool::~ThreadPool() {
+    Stop();
+}
+
+size_t ThreadPool::DefaultWorkers() {
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    return 0;
+#else
+    const int cores = SDL_GetNumLogicalCPUCores();
+    return cores > 1 ? static_cast<size_t>(cores - 1) : 0;
+#endif
+}
+
+void ThreadPool::Start(size_t workers) {
+    Stop();
+    mStop = false;
+    mThreads.reserve(workers);
+    for (size_t i = 0; i < workers; ++i)
+        // start from the current generation so a restarted pool doesn't replay the last loop
+        mThreads.emplace_back(&ThreadPool::Worker, this, mGeneration);
+}
+
+void ThreadPool::Stop() {
+    {
+        std::lock_guard lock(mMutex);
+        mStop = true;
+    }
+    mWake.notify_all();
+    for (std::thread& t : mThreads) t.join();
+    mThreads.clear();
+}
+
+void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)>& fn) {
+    if (count == 0) return;
+    // nobody to share with (or nothing to share): skip the handoff entirely
+    if (mThreads.empty() || count == 1) {
+        for (size_t i = 0; i < count; ++i) fn(i);
+        return;
+    }
+
+    {
+        std::lock_guard lock(mMutex);
+        mJob    = &fn;
+        mCount  = count;
+        mNext.store(0, std::memory_order_relaxed);
+        mActive = mThreads.size();
+        mError  = nullptr;
+        ++mGeneration;
+    }
+    mWake.notify_all();
+    RunIndices();
+
+    // every worker has to check out before fn (and this loop's state) can go away
+    std::unique_lock lock(mMutex);
+    mDone.wait(lock, [this] { return mActive == 0; });
+    mJob = nullptr;
+    if (mError) std::rethrow_exception(std::exchange(mError, nullptr));
+}
+
+void ThreadPool::RunIndices() {
+    for (size_t i = mNext.fetch_add(1, std::memory_order_relaxed); i < mCount;
+         i = mNext.fetch_add(1, std::memory_order_relaxed)) {
+        try {
+            (*mJob)(i);
+        } catch (...) {
+            std::lock_guard lock(mMutex);
+            if (!mError) mError = std::current_exception();
+        }
+    }
+}
+
+void ThreadPool::Worker(uint64_t seen) {
+    NN_TRACE_THREAD("pool worker");
+    for (;;) {
+        {
+            std::unique_lock lock(mMutex);
+            mWake.wait(lock, [&] { return mStop || mGeneration != seen; });
+            if (mStop) return;
+            seen = mGeneration;
+        }
+        RunIndices();
+        {
+            std::lock_guard lock(mMutex);
+            if (--mActive == 0) mDone.notify_one();
+        }
+    }
+}
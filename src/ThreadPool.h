@@ -0,0 +1,58 @@
+//
+// Created by Ben Meyers on 3/21/26.
+//
+
+#ifndef NEURAL_NETWORK_CIRCUIT_VISUALIZATION_THREADPOOL_H
+#define NEURAL_NETWORK_CIRCUIT_VISUALIZATION_THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A fixed set of worker threads for fork/join loops: ParallelFor hands out indices until they run out,
+// the calling thread works alongside the pool, and the call returns once every index is done.
+// One loop at a time, started from one thread (the main loop); fn must not start another ParallelFor.
+class ThreadPool {
+public:
+    ThreadPool() = default;
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // one less than the logical cores (the caller is the last one), 0 where threads aren't available
+    static size_t DefaultWorkers();
+
+    // 0 workers is valid: every ParallelFor then runs inline on the caller
+    void Start(size_t workers);
+    void Stop();
+    [[nodiscard]] size_t Workers() const { return mThreads.size(); }
+
+    // fn(i) for every i in [0, count), in no particular order across threads.
+    // the first exception thrown by fn is rethrown here after the loop finishes
+    void ParallelFor(size_t count, const std::function<void(size_t)>& fn);
+
+private:
+    void Worker(uint64_t seen);
+    void RunIndices();
+
+    std::vector<std::thread> mThreads;
+    std::mutex               mMutex;
+    std::condition_variable  mWake;  // workers: a new loop (or stop) is posted
+    std::condition_variable  mDone;  // caller: the last worker left the loop
+
+    // current loop; written under mMutex before mGeneration ticks
+    const std::function<void(size_t)>* mJob = nullptr;
+    size_t              mCount = 0;
+    std::atomic<size_t> mNext{0};
+    size_t              mActive = 0;  // workers still inside the current loop
+    uint64_t            mGeneration = 0;
+    bool                mStop = false;
+    std::exception_ptr  mError;
+};
+
+#endif //NEURAL_NETWORK_CIRCUIT_VISUALIZATION_THREADPOOL_H
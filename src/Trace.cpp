@@ -0,0 +1,154 @@
+//
+// Created by Ben Meyers on 3/23/26.
+//
+
+#include "Trace.h"
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+    struct Slot {
+        std::atomic<const char*> name{nullptr};
+        std::atomic<uint64_t>    start{0}, end{0};
+        std::atomic<int64_t>     arg{-1};
+    };
+
+    // one writer (its thread), any number of readers (Dump). the writer bumps mBegun before touching a
+    // slot and mDone after, so a reader can tell which of the slots it copied might have been overwritten
+    struct ThreadBuffer {
+        std::unique_ptr<Slot[]> slots{new Slot[Trace::RING_EVENTS]};
+        std::atomic<uint64_t>   begun{0}, done{0};
+        std::atomic<bool>       retired{false};  // its thread exited; a new thread may take it over
+        uint32_t                tid = 0;
+        std::string             name;            // guarded by gRegistryMutex
+    };
+
+    std::mutex gRegistryMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> gBuffers;
+    const auto gEpoch = std::chrono::steady_clock::now();
+
+    // releases the thread's buffer for reuse when the thread exits, so restarting a worker doesn't grow the registry
+    struct ThreadSlot {
+        ThreadBuffer* buffer = nullptr;
+        ~ThreadSlot() {
+            if (buffer) buffer->retired.store(true, std::memory_order_release);
+        }
+    };
+    thread_local ThreadSlot tThread;
+
+    ThreadBuffer& ThisThread() {
+        if (tThread.buffer) return *tThread.buffer;
+        std::lock_guard lock(gRegistryMutex);
+        for (auto& b : gBuffers) {
+            if (b->retired.load(std::memory_order_acquire)) {
+                b->retired.store(false, std::memory_order_relaxed);
+                b->name.clear();
+                // the dead thread's events would otherwise be exported under the new thread's name.
+                // Dump holds the registry lock while it reads, so it sees the ring either before or after this
+                b->begun.store(0, std::memory_order_relaxed);
+                b->done.store(0, std::memory_order_relaxed);
+                tThread.buffer = b.get();
+                return *b;
+            }
+        }
+        gBuffers.push_back(std::make_unique<ThreadBuffer>());
+        gBuffers.back()->tid = static_cast<uint32_t>(gBuffers.size());
+        tThread.buffer = gBuffers.back().get();
+        return *tThread.buffer;
+    }
+
+    // only Dump needs these, and it only does anything with tracing compiled in
+#if NN_TRACING
+    void WriteEscaped(std::FILE* f, const char* s) {
+        for (; *s; ++s) {
+            if (*s == '"' || *s == '\\') std::fputc('\\', f);
+            std::fputc(*s, f);
+        }
+    }
+
+    struct Event {
+        const char* name;
+        uint64_t    start, end;
+        int64_t     arg;
+    };
+#endif
+}
+
+uint64_t Trace::NowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - gEpoch).count());
+}
+
+void Trace::Record(const char* name, uint64_t startNs, uint64_t endNs, int64_t arg) {
+    ThreadBuffer& b = ThisThread();
+    const uint64_t i = b.done.load(std::memory_order_relaxed);
+    b.begun.store(i + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    Slot& s = b.slots[i & (RING_EVENTS - 1)];
+    s.name.store(name, std::memory_order_relaxed);
+    s.start.store(startNs, std::memory_order_relaxed);
+    s.end.store(endNs, std::memory_order_relaxed);
+    s.arg.store(arg, std::memory_order_relaxed);
+    b.done.store(i + 1, std::memory_order_release);
+}
+
+void Trace::SetThreadName(const char* name) {
+    ThreadBuffer& b = ThisThread();
+    std::lock_guard lock(gRegistryMutex);
+    b.name = name;
+}
+
+bool Trace::Dump(const char* path) {
+#if !NN_TRACING
+    (void)path;
+    return false;
+#else
+    std::FILE* f = std::fopen(path, "w");
+    if (!f) return false;
+
+    std::lock_guard lock(gRegistryMutex);
+    std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", f);
+    bool first = true;
+    std::vector<Event> events;
+    for (const auto& b : gBuffers) {
+        // copy out what's published, then drop anything the writer may have lapped while we read
+        const uint64_t done = b->done.load(std::memory_order_acquire);
+        const uint64_t from = done > RING_EVENTS ? done - RING_EVENTS : 0;
+        events.clear();
+        for (uint64_t i = from; i < done; ++i) {
+            const Slot& s = b->slots[i & (RING_EVENTS - 1)];
+            events.push_back({s.name.load(std::memory_order_relaxed), s.start.load(std::memory_order_relaxed),
+                              s.end.load(std::memory_order_relaxed), s.arg.load(std::memory_order_relaxed)});
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t begun = b->begun.load(std::memory_order_relaxed);
+        const uint64_t safe  = begun > RING_EVENTS ? begun - RING_EVENTS : 0;
+        const size_t skip    = safe > from ? static_cast<size_t>(safe - from) : 0;
+
+        std::fprintf(f, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"",
+                     first ? "" : ",\n", b->tid);
+        WriteEscaped(f, b->name.empty() ? "thread" : b->name.c_str());
+        std::fputs("\"}}", f);
+        first = false;
+
+        for (size_t k = skip; k < events.size(); ++k) {
+            const Event& e = events[k];
+            std::fputs(",\n{\"ph\":\"X\",\"name\":\"", f);
+            WriteEscaped(f, e.name);
+            // trace-event times are microseconds
+            std::fprintf(f, "\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f", b->tid,
+                         static_cast<double>(e.start) / 1000.0, static_cast<double>(e.end - e.start) / 1000.0);
+            if (e.arg >= 0) std::fprintf(f, ",\"args\":{\"i\":%" PRId64 "}", e.arg);
+            std::fputc('}', f);
+        }
+    }
+    std::fputs("\n]}\n", f);
+    return std::fclose(f) == 0;
+#endif
+}
@@ -0,0 +1,65 @@
+//
+// Created by Ben Meyers on 3/23/26.
+//
+
+#ifndef NEURAL_NETWORK_CIRCUIT_VISUALIZATION_TRACE_H
+#define NEURAL_NETWORK_CIRCUIT_VISUALIZATION_TRACE_H
+
+#include <cstdint>
+
+// Scoped timers for the hot paths, recorded into a fixed ring buffer per thread (no locks, no
+// allocation after a thread's first event) and written out as Chrome trace-event JSON, which
+// chrome://tracing and ui.perfetto.dev both open. Compiled out entirely unless NN_TRACING is 1
+// (CMake option NN_TRACING).
+#ifndef NN_TRACING
+#define NN_TRACING 0
+#endif
+
+namespace Trace {
+    // events kept per thread; older ones are overwritten
+    constexpr uint64_t RING_EVENTS = 1u << 16;
+
+    [[nodiscard]] uint64_t NowNs();
+    // name must outlive the trace (a string literal); arg < 0 means none
+    void Record(const char* name, uint64_t startNs, uint64_t endNs, int64_t arg);
+    // label for the calling thread's track
+    void SetThreadName(const char* name);
+    // per-thread switch, on by default. a thread running something thousands of times a second
+    // (the trainer) samples by only enabling it now and then, which also keeps the ring from being flooded
+    inline thread_local bool tEnabled = true;
+    inline void SetThreadEnabled(bool enabled) { tEnabled = enabled; }
+
+    // every thread's retained events as {"traceEvents": [...]}. false if tracing is compiled out or the file won't open
+    bool Dump(const char* path);
+
+    class Scope {
+    public:
+        explicit Scope(const char* name, int64_t arg = -1)
+            : mName(tEnabled ? name : nullptr), mArg(arg), mStart(mName ? NowNs() : 0) {}
+        ~Scope() {
+            if (mName) Record(mName, mStart, NowNs(), mArg);
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        const char* mName;
+        int64_t     mArg;
+        uint64_t    mStart;
+    };
+}
+
+#if NN_TRACING
+#define NN_TRACE_CONCAT_INNER(a, b) a##b
+#define NN_TRACE_CONCAT(a, b) NN_TRACE_CONCAT_INNER(a, b)
+// times the rest of the enclosing block
+#define NN_TRACE_SCOPE(name) const Trace::Scope NN_TRACE_CONCAT(nnTraceScope, __LINE__){name}
+// same, tagged with a number (layer, column...) shown as args.i
+#define NN_TRACE_SCOPE_ARG(name, arg) const Trace::Scope NN_TRACE_CONCAT(nnTraceScope, __LINE__){name, static_cast<int64_t>(arg)}
+#define NN_TRACE_THREAD(name) Trace::SetThreadName(name)
+#else
+#define NN_TRACE_SCOPE(name) ((void)0)
+#define NN_TRACE_SCOPE_ARG(name, arg) ((void)0)
+#define NN_TRACE_THREAD(name) ((void)0)
+#endif
+
+#endif //NEURAL_NETWORK_CIRCUIT_VISUALIZATION_TRACE_H
@@ -0,0 +1,84 @@
+//
+// Created by Ben Meyers on 3/18/26.
+//
+
+#include "Trainer.h"
+#include <chrono>
+#include "Perf.h"
+#include "Trace.h"
+
+Trainer::~Trainer() {
+    if (mRunning) Stop();
+}
+
+void Trainer::Start(NeuralNetwork nn, DynamicMatrix input, DynamicMatrix target, float lr, float l1) {
+    if (mRunning) Stop();
+    mNN = std::move(nn);
+    mInput = std::move(input);
+    mTarget = std::move(target);
+    mLr = lr;
+    mL1 = l1;
+    mSteps.store(0, std::memory_order_relaxed);
+    mStop.store(false, std::memory_order_relaxed);
+    // nothing from a previous run should show up as "latest"
+    mSnapshots.TakeLatest();
+    mRunning = true;
+#if NN_TRAINER_THREADS
+    mThread = std::thread(&Trainer::Run, this);
+#endif
+}
+
+NeuralNetwork Trainer::Stop() {
+    if (!mRunning) return std::move(mNN);
+    mStop.store(true, std::memory_order_relaxed);
+#if NN_TRAINER_THREADS
+    mThread.join();
+#endif
+    mRunning = false;
+    return std::move(mNN);
+}
+
+void Trainer::Poll() {
+#if !NN_TRAINER_THREADS
+    if (!mRunning) return;
+    const size_t n = GetVisualizeEvery();
+    for (size_t i = 0; i < n; ++i) Step();
+#endif
+}
+
+void Trainer::Run() {
+    NN_TRACE_THREAD("trainer");
+    while (!mStop.load(std::memory_order_relaxed)) Step();
+}
+
+void Trainer::Step() {
+    // only the steps that get published are traced, the rest run untimed
+    Trace::SetThreadEnabled((mSteps.load(std::memory_order_relaxed) + 1) % GetVisualizeEvery() == 0);
+    const auto start = std::chrono::steady_clock::now();
+    TrainSnapshot snap = [this] {
+        Perf::PhaseScope phase(Perf::TRAIN_STEP);
+        return mNN.TrainStep(mInput, mTarget, mLr, mL1);
+    }();
+    mLastStepMs.store(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count(),
+                      std::memory_order_relaxed);
+    const uint64_t step = mSteps.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (step % GetVisualizeEvery() != 0) return;
+
+    // only published steps pay for a copy of the layers and stats. the back slot is filled in place:
+    // this step's results move in, and the layers and stats are copied into the buffers the slot already
+    // holds (the reader swaps its previous ones back rather than keeping them), so a publish doesn't allocate
+    NN_TRACE_SCOPE("Trainer::Publish");
+    TrainSnapshot& slot = mSnapshots.Back();
+    slot.activations     = std::move(snap.activations);
+    slot.deltas          = std::move(snap.deltas);
+    slot.weightGradients = std::move(snap.weightGradients);
+    slot.loss            = snap.loss;
+    slot.skippedDeltaFraction = snap.skippedDeltaFraction;
+    slot.step            = step;
+    slot.stats           = mNN.Stats();
+    // edge lists are only cut for the steps someone will see
+    mNN.RefreshEdges();
+    // element by element, so weights, half copies and edge rows all land in existing storage
+    slot.layers = mNN.Layers();
+    mSnapshots.Publish();
+}
@@ -0,0 +1,74 @@
+//
+// Created by Ben Meyers on 3/18/26.
+//
+
+#ifndef NEURAL_NETWORK_CIRCUIT_VISUALIZATION_TRAINER_H
+#define NEURAL_NETWORK_CIRCUIT_VISUALIZATION_TRAINER_H
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include "NeuralNetwork.h"
+#include "TripleBuffer.h"
+
+// web builds without pthreads can't start a thread, so the trainer runs its steps from Poll() on the main loop
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+#define NN_TRAINER_THREADS 1
+#else
+#define NN_TRAINER_THREADS 0
+#endif
+
+// Trains a network continuously on its own thread, as fast as it can step.
+// Every Nth step it publishes a TrainSnapshot (with a copy of the layers, so the renderer
+// never touches the network being trained) through a wait-free triple buffer.
+class Trainer {
+public:
+    static constexpr size_t DEFAULT_VISUALIZE_EVERY = 10;
+
+    Trainer() = default;
+    ~Trainer();
+    Trainer(const Trainer&) = delete;
+    Trainer& operator=(const Trainer&) = delete;
+
+    // takes the network for as long as training runs
+    void Start(NeuralNetwork nn, DynamicMatrix input, DynamicMatrix target, float lr, float l1);
+    // joins the thread and hands the trained network back
+    NeuralNetwork Stop();
+    [[nodiscard]] bool Running() const { return mRunning; }
+
+    // publish one snapshot per n steps (copying the layers isn't free, so don't pay it for every step)
+    void SetVisualizeEvery(size_t n) { mVisualizeEvery.store(n == 0 ? 1 : n, std::memory_order_relaxed); }
+    [[nodiscard]] size_t GetVisualizeEvery() const { return mVisualizeEvery.load(std::memory_order_relaxed); }
+    [[nodiscard]] uint64_t Steps() const { return mSteps.load(std::memory_order_relaxed); }
+    // wall time of the most recent TrainStep
+    [[nodiscard]] float LastStepMs() const { return mLastStepMs.load(std::memory_order_relaxed); }
+
+    // render thread: newest snapshot since the last call (safe to move from), or nullptr.
+    // swapping its layers and stats out instead leaves the slot buffers the next publish can copy into without allocating
+    TrainSnapshot* TakeLatest() { return mSnapshots.TakeLatest(); }
+
+    // once per frame. no-op when training has its own thread; otherwise runs one publish interval of steps here
+    void Poll();
+
+private:
+    void Run();
+    void Step();
+
+    NeuralNetwork mNN;
+    DynamicMatrix mInput{1, 1};
+    DynamicMatrix mTarget{1, 1};
+    float mLr = 0.0f;
+    float mL1 = 0.0f;
+
+    bool mRunning = false;
+#if NN_TRAINER_THREADS
+    std::thread mThread;
+#endif
+    std::atomic<bool>     mStop{false};
+    std::atomic<size_t>   mVisualizeEvery{DEFAULT_VISUALIZE_EVERY};
+    std::atomic<uint64_t> mSteps{0};
+    std::atomic<float>    mLastStepMs{0.0f};
+    TripleBuffer<TrainSnapshot> mSnapshots;
+};
+
+#endif //NEURAL_NETWORK_CIRCUIT_VISUALIZATION_TRAINER_H
@@ -0,0 +1,47 @@
+//
+// Created by Ben Meyers on 3/18/26.
+//
+
+#ifndef NEURAL_NETWORK_CIRCUIT_VISUALIZATION_TRIPLEBUFFER_H
+#define NEURAL_NETWORK_CIRCUIT_VISUALIZATION_TRIPLEBUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+// Wait-free single-writer / single-reader "latest value" exchange.
+// The writer fills Back() and Publish()es it; the reader TakeLatest()s whenever it likes and gets the newest
+// published value, skipping any it missed. Neither side ever blocks: each owns one slot outright
+// and they trade through the third (the middle) with a single atomic exchange.
+template<typename T>
+class TripleBuffer {
+    static constexpr uint8_t INDEX_MASK = 3;
+    static constexpr uint8_t FRESH_BIT  = 4;  // middle holds a value the reader hasn't taken yet
+
+    T mSlots[3];
+    alignas(64) std::atomic<uint8_t> mMiddle{1};
+    alignas(64) uint8_t mBack  = 0;  // writer's slot
+    alignas(64) uint8_t mFront = 2;  // reader's slot
+
+public:
+    TripleBuffer() = default;
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // writer side: fill this, then Publish()
+    T& Back() { return mSlots[mBack]; }
+    void Publish() {
+        const uint8_t old = mMiddle.exchange(static_cast<uint8_t>(mBack | FRESH_BIT), std::memory_order_acq_rel);
+        mBack = old & INDEX_MASK;
+    }
+
+    // reader side: the newest published value (the reader's to keep, or move from, until its next call),
+    // or nullptr if nothing was published since the last take
+    T* TakeLatest() {
+        if (!(mMiddle.load(std::memory_order_relaxed) & FRESH_BIT)) return nullptr;
+        const uint8_t old = mMiddle.exchange(mFront, std::memory_order_acq_rel);
+        mFront = old & INDEX_MASK;
+        return &mSlots[mFront];
+    }
+};
+
+#endif //NEURAL_NETWORK_CIRCUIT_VISUALIZATION_TRIPLEBUFFER_H
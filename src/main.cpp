@@ -4,6 +4,9 @@
 
 SDL_AppResult SDL_AppInit(void** appstate, int argc, char** argv)
 {
+    if (!gGame.ParseArgs(argc, argv)) return SDL_APP_FAILURE;
+    // --pipeline only measures training, then quits without a window
+    if (gGame.IsPipelineBench()) return gGame.RunPipelineBench() ? SDL_APP_SUCCESS : SDL_APP_FAILURE;
     bool init = gGame.Initialize();
     return init ? SDL_APP_CONTINUE : SDL_APP_FAILURE;
 }